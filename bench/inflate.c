@@ -0,0 +1,81 @@
+#include <notstd/core.h>
+#include <notstd/str.h>
+#include <notstd/delay.h>
+
+#include <auror/archive.h>
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define BENCH_ROUND 10
+
+__private void* bench_load(const char* path){
+	int fd = open(path, O_RDONLY);
+	if( fd < 0 ) die("unable to open %s: %m", path);
+	struct stat st;
+	if( fstat(fd, &st) ) die("unable to stat %s: %m", path);
+	char* buf = MANY(char, st.st_size + 1);
+	ssize_t nr;
+	while( (nr=read(fd, &buf[mem_header(buf)->len], st.st_size - mem_header(buf)->len)) > 0 ){
+		mem_header(buf)->len += nr;
+	}
+	close(fd);
+	if( nr < 0 ) die("unable to read %s: %m", path);
+	return buf;
+}
+
+__private void bench_file(const char* path, unsigned round){
+	__free void* data = bench_load(path);
+	__free void* ref  = NULL;
+	printf("%s %u bytes\n", path, mem_header(data)->len);
+	for( unsigned i = 0; DECOMPRESSORS[i].name; ++i ){
+		if( DECOMPRESSORS[i].type != DECOMPRESS_GZIP ) continue;
+		delay_t best = (delay_t)-1;
+		delay_t total = 0;
+		size_t size = 0;
+		for( unsigned r = 0; r < round; ++r ){
+			delay_t st = time_us();
+			void* dec = DECOMPRESSORS[i].decompress(data);
+			delay_t en = time_us() - st;
+			if( !dec ) die("%s fail decompression %s", DECOMPRESSORS[i].name, path);
+			size = mem_header(dec)->len;
+			if( !ref ){
+				ref = dec;
+			}
+			else{
+				if( size != mem_header(ref)->len || memcmp(dec, ref, size) ) die("%s decompression mismatch", DECOMPRESSORS[i].name);
+				mem_free(dec);
+			}
+			total += en;
+			if( en < best ) best = en;
+		}
+		printf("  %-12s %10zu bytes best %8luus avg %8luus %8.1f MiB/s\n",
+			DECOMPRESSORS[i].name,
+			size,
+			best,
+			total / round,
+			(double)size / (1024.0*1024.0) / ((double)best / 1000000.0)
+		);
+	}
+}
+
+int main(int argc, char** argv){
+	notstd_begin();
+	if( argc < 2 ){
+		fprintf(stderr, "usage: %s [-n round] <repo.db>...\n", argv[0]);
+		return 1;
+	}
+	unsigned round = BENCH_ROUND;
+	int i = 1;
+	if( !strcmp(argv[1], "-n") && argc > 3 ){
+		round = strtoul(argv[2], NULL, 10);
+		if( !round ) round = 1;
+		i = 3;
+	}
+	for( ; i < argc; ++i ){
+		bench_file(argv[i], round);
+	}
+	return 0;
+}
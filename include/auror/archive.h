@@ -8,36 +8,97 @@
 
 typedef enum { TAR_FILE, TAR_HARD_LINK, TAR_SYMBOLIC_LINK, TAR_CHAR_DEV, TAR_BLK_DEV, TAR_DIR, TAR_FIFO, TAR_CONTIGUOUS, TAR_GLOBAL, TAR_EXTEND, TAR_VENDOR } tartype_e;
 
+//views borrowed from archive, path and link are not null terminated
+typedef struct tarview{
+	const char* str;
+	size_t      len;
+}tarview_s;
+
 typedef struct tarent_s{
-	char      path[PATH_MAX];
-	size_t    size;
-	tartype_e type;
-	void*     data;
-	uid_t     uid;
-	gid_t     gid;
-	unsigned  perm;
+	tarview_s   path;
+	tarview_s   prefix;
+	tarview_s   link;
+	size_t      size;
+	tartype_e   type;
+	void*       data;
+	const void* header;
 }tarent_s;
 
+typedef struct tarpax{
+	size_t    size;
+	tarview_s path;
+	tarview_s link;
+}tarpax_s;
+
 typedef struct tar_s{
 	void*     start;
 	uintptr_t loaddr;
 	size_t    end;
-	tarent_s  global;
+	tarpax_s  global;
 	int       err;
+	char      gpath[PATH_MAX];
 }tar_s;
 
 typedef z_stream gzip_t;
 
+typedef enum { DECOMPRESS_GZIP, DECOMPRESS_ZSTD, DECOMPRESS_UNKNOW } decompress_e;
+
+//whole buffer decompression, data and return are mem buffer
+typedef struct decompressor{
+	const char*  name;
+	decompress_e type;
+	void*        (*decompress)(void* data);
+}decompressor_s;
+
+typedef int (*tarstream_f)(void* ctx, tarent_s* ent);
+typedef void (*tarrestart_f)(void* ctx);
+
+//compressed tar consumed while decoding, each complete entry is passed to fn and is valid only inside the call
+typedef struct tarstream{
+	decompress_e        format;
+	uint8_t             magic[4];
+	unsigned            nmagic;
+	gzip_t              gz;
+	struct ZSTD_DCtx_s* zstd;
+	tar_s               tar;
+	char*               pending;
+	size_t              consumed;
+	size_t              total_out;
+	tarstream_f         fn;
+	tarrestart_f        restart;
+	void*               ctx;
+	int                 end;
+	int                 eot;
+	int                 err;
+}tarstream_s;
+
 gzip_t* gzip_ctor(gzip_t* gz);
 void gzip_dtor(gzip_t* gz);
-int gzip_decompress(gzip_t* gz, void* data, size_t size);
+
+extern const decompressor_s DECOMPRESSORS[];
+
+decompress_e decompress_sniff(const void* data, size_t size);
+size_t decompress_file_size(int fd);
+const decompressor_s* decompressor_get(decompress_e type);
+void* decompress_all(void* data);
 void* gzip_decompress_all(void* data);
 
 void* zstd_decompress(void* data);
+void* zstd_decompress_chunked(void* data, size_t chunk);
 
 void tar_mopen(tar_s* tar, void* data);
 tarent_s* tar_next(tar_s* tar, tarent_s* ent);
 int tar_errno(tar_s* tar);
-unsigned tar_count(void* data, tartype_e type);
+size_t tarent_path(tarent_s* ent, char* path, size_t size);
+uid_t tarent_uid(tarent_s* ent);
+gid_t tarent_gid(tarent_s* ent);
+unsigned tarent_perm(tarent_s* ent);
+unsigned long tarent_mtime(tarent_s* ent);
+
+tarstream_s* tarstream_ctor(tarstream_s* ts, tarstream_f fn, tarrestart_f restart, void* ctx);
+void tarstream_dtor(void* pts);
+void tarstream_restart(tarstream_s* ts);
+int tarstream_feed(tarstream_s* ts, void* data, size_t size);
+int tarstream_finish(tarstream_s* ts);
 
 #endif
@@ -0,0 +1,22 @@
+#ifndef __ATOM_H__
+#define __ATOM_H__
+
+#include <notstd/core.h>
+
+#include <stdint.h>
+
+//interned package names, same name same atom for all databases
+//atom is (index in shard << ATOM_SHARD_BITS) | shard, index start from 1, 0 is never used
+#define ATOM_NONE        0
+#define ATOM_SHARD_BITS  6
+#define ATOM_SHARDS      (1 << ATOM_SHARD_BITS)
+#define ATOM_TABLE_SIZE  256
+#define ATOM_NAMES_CHUNK (4096*16)
+
+typedef uint32_t atom_t;
+
+atom_t atom_intern(const char* name);
+atom_t atom_find(const char* name);
+const char* atom_name(atom_t atom);
+
+#endif
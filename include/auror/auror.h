@@ -9,6 +9,9 @@ typedef enum{
 	O_n,
 	O_d,
 	O_c,
+	O_o,
+	O_r,
+	O_t,
 	O_h
 }OPT_E;
 
@@ -3,14 +3,20 @@
 
 #include <notstd/json.h>
 #include <notstd/fzs.h>
-#include <notstd/rbtree.h>
 #include <notstd/list.h>
+#include <notstd/rhhash.h>
 
 #include <auror/config.h>
 #include <auror/status.h>
+#include <auror/snapshot.h>
+#include <auror/atom.h>
+#include <auror/evr.h>
+#include <auror/fileindex.h>
 
 #define DESC_DEFAULT_SIZE    1024
 #define BUFLOAD_DEFAULT_SIZE (4096*1024)
+#define DATABASE_STORE_BLOCK (4096*256)
+#define DATABASE_PARALLEL_SIZE (4096*1024)
 
 typedef struct desc     desc_s;
 typedef struct database database_s;
@@ -21,24 +27,30 @@ typedef struct database database_s;
 #define DESC_FLAG_REMOVED   0x0008
 #define DESC_FLAG_INSTALLED 0x0010
 #define DESC_FLAG_CROSS     0x0020
+#define DESC_FLAG_LAZY      0x0040
 #define DESC_FLAG_V_LESS    0x0100
 #define DESC_FLAG_V_EQUAL   0x0200
 #define DESC_FLAG_V_GREATER 0x0400
 
 #define DATABASE_FLAG_MULTIMEM 0x01
+#define DATABASE_FLAG_FROZEN   0x02
+
+#define DATABASE_ARENA_CHUNK (4096*64)
+#define DATABASE_ATOMS_SIZE  (4096*4)
+#define DATABASE_ELEMENTS    1024
+#define DATABASE_FILEINDEX   "local.fileindex"
+#define DATABASE_LOCAL_BATCH 128
 
 typedef struct pkgver{
 	char*    name;
 	char*    version;
 	unsigned flags;
+	atom_t   atom;
+	evr_s    evr;
 }pkgver_s;
 
-struct desc{
-	inherit_ld(struct desc);
-	rbtNode_s node;
-	database_s* db;
-	desc_s* link;
-	char* name;
+//descriptive metadata, not used from resolver and index
+typedef struct descInfo{
 	char* filename;
 	char* base;
 	char* desc;
@@ -47,43 +59,92 @@ struct desc{
 	char* arch;
 	char* packager;
 	char* validation;
-	char* version;
 	char* md5sum;
 	char* sha256sum;
 	char* pgpsig;
 	char* maintainer;
 	char** groups;
-	char** replaces;
-	char** provides;
 	char** xdata;
 	char** license;
-	pkgver_s* depends;
 	pkgver_s* makedepends;
 	pkgver_s* checkdepends;
 	pkgver_s* optdepends;
-	pkgver_s* conflicts;
 	unsigned long builddate;
 	unsigned long installdate;
 	unsigned long csize;
 	unsigned long isize;
 	unsigned long size;
-	unsigned long reason;
-	unsigned long flags;
 	unsigned long numvotes;
 	unsigned long outofdate;
 	double popularity;
+}descInfo_s;
+
+//virtual desc (provide/replace) not have info, use link
+struct desc{
+	inherit_ld(struct desc);
+	database_s* db;
+	desc_s* link;
+	atom_t atom;
+	char* name;
+	char* version;
+	evr_s evr;
+	char** replaces;
+	char** provides;
+	pkgver_s* depends;
+	pkgver_s* conflicts;
+	unsigned long reason;
+	unsigned long flags;
 	int var;
+	uint64_t lazy;
+	char** raw;
+	descInfo_s* info;
 };
 
+//provides and replaces grouped by atom, group is cand[first[atom]..first[atom+1]] sorted by evr_order, unversioned first
+//before database_provides_index cand is only the list of virtual desc
+typedef struct provideIndex{
+	uint32_t* first;
+	desc_s**  cand;
+}provideIndex_s;
+
+//packages that depend from atom are dependents[first[atom]..first[atom+1]], only if database_rdepends_index is called before database_freeze
+typedef struct rdependsIndex{
+	uint32_t* first;
+	desc_s**  dependents;
+}rdependsIndex_s;
+
+//after database_freeze database is read only and can be shared from threads without lock
+//elements are sorted by name, names map name to head, real packages of atom are chain[first[atom]..first[atom+1]]
+//lazy fields of info are read with desc_info, it decode them once and is thread safe
+typedef struct frozenIndex{
+	uint32_t* first;
+	desc_s**  chain;
+	rhhash_s  names;
+}frozenIndex_s;
+
 struct database{
 	void*               mem;
 	configRepository_s* repo;
-	rbtree_s            elements;
+	desc_s**            elements;
+	provideIndex_s      provides;
+	rdependsIndex_s     rdepends;
+	frozenIndex_s       frozen;
+	marena_s*           arena;
+	desc_s**            atoms;
+	fileindex_s*        files;
 	unsigned            flags;
+	unsigned            unknown;
 };
 
+//sync repository in config order that have real or virtual atom, are repo[first[atom]..first[atom+1]]
+typedef struct syncIndex{
+	uint32_t*    first;
+	database_s** repo;
+}syncIndex_s;
+
 typedef struct arch{
 	database_s** sync;
+	syncIndex_s  index;
 	database_s*  local;
 	database_s*  aur;
 }arch_s;
@@ -91,20 +152,40 @@ typedef struct arch{
 unsigned desc_parse_and_split_name_version(char* name, char** version);
 desc_s* desc_unpack(database_s* db, unsigned flags, char* parse, size_t size, int checkmakepkg);
 desc_s* desc_link(database_s* db, desc_s* link, char* name, char* version, unsigned flags);
-desc_s* desc_unpack_json(database_s* db, unsigned flags, jvalue_s* pkgobj);
+desc_s* desc_unpack_aur(database_s* db, unsigned flags, char** par);
+descInfo_s* desc_info(desc_s* desc);
 desc_s* desc_nonvirtual(desc_s* desc);
 desc_s* desc_nonvirtual_dump(desc_s* desc);
-bool desc_accept_version(desc_s* d, unsigned flags, const char* version);
+bool desc_accept_version(desc_s* d, unsigned flags, const evr_s* version);
+void desc_snapshot_fields(snapw_s* sw);
+int desc_snapshot_check(snapshot_s* snap);
+void desc_snapshot_store(snapw_s* sw, desc_s* desc);
+desc_s* desc_snapshot_load(database_s* db, snapshot_s* snap, const uint32_t** record);
 
 database_s* database_ctor(database_s* db, configRepository_s* repo, unsigned flags);
+void database_dtor(database_s* db);
+desc_s* database_search_byatom(database_s* db, atom_t atom);
 desc_s* database_search_byname(database_s* db, const char* name);
 desc_s* database_search_bydesc(database_s* db, desc_s* desc);
+desc_s** database_sorted(database_s* db);
 void database_insert(database_s* db, desc_s* desc);
 void database_insert_provides(database_s* db, desc_s* desc);
 void database_insert_replaces(database_s* db, desc_s* desc);
-desc_s* database_sync_find(database_s** db, const char* name);
-void database_sync(arch_s* arch, config_s* conf, status_s* status, int forcenodowanload);
-void database_import_json(database_s* db, unsigned flags, jvalue_s* results);
+void database_provides_index(database_s* db);
+desc_s** database_provides(database_s* db, atom_t atom, unsigned* count);
+desc_s** database_provides_accept(database_s* db, desc_s** out, atom_t atom, unsigned flags, const evr_s* version);
+void database_freeze(database_s* db);
+desc_s** database_candidates(database_s* db, atom_t atom, unsigned* count);
+void database_rdepends_index(database_s* db);
+desc_s** database_rdepends(database_s* db, atom_t atom, unsigned* count);
+desc_s** database_required_by(database_s* db, desc_s* desc, desc_s** out);
+desc_s** database_orphans(database_s* db, desc_s** out);
+database_s** database_sync_repository(arch_s* arch, atom_t atom, unsigned* count);
+desc_s* database_sync_find_atom(arch_s* arch, atom_t atom);
+desc_s* database_sync_find(arch_s* arch, const char* name);
+void database_sync(arch_s* arch, config_s* conf, status_s* status, int forcenodowanload, int rdepends);
+char* database_import_aur(database_s* db, unsigned flags, char* body, char** error);
+fzs_s* database_sync_match_fuzzy(fzs_s* vf, arch_s* arch, const char* name);
 fzs_s* database_match_fuzzy(fzs_s* vf, database_s* db, const char* name);
 
 
@@ -4,9 +4,12 @@
 #include <notstd/delay.h>
 #include <auror/config.h>
 #include <auror/status.h>
+#include <auror/archive.h>
+
+#define DOWNLOAD_NOT_MODIFIED 1
 
 int download_lastsync(config_s* conf, delay_t* lastsync);
-void* download_database(const char* dbtmpname, status_s* status, unsigned idstatus, configRepository_s* repo, config_s* conf);
+int download_database(const char* dbtmpname, const char* dbpath, status_s* status, unsigned idstatus, configRepository_s* repo, config_s* conf, tarstream_s* ts, int conditional);
 
 
 
@@ -0,0 +1,39 @@
+#ifndef __EVR_H__
+#define __EVR_H__
+
+#include <notstd/core.h>
+
+#include <stdint.h>
+
+#define EVR_EPOCH   0
+#define EVR_VERSION 1
+#define EVR_RELEASE 2
+#define EVR_PARTS   3
+
+#define EVR_STACK_SEGMENTS 64
+
+//alnum run of version, numbers not have leading zeros, sep is the count of not alnum char before segment
+typedef struct evrSegment{
+	const char* str;
+	uint32_t    len;
+	uint16_t    sep;
+	uint16_t    num;
+}evrSegment_s;
+
+//[epoch:]version[-release] pre tokenized, segments point to the version string
+typedef struct evr{
+	evrSegment_s* seg;
+	uint16_t      count[EVR_PARTS];
+	uint8_t       trail[EVR_PARTS];
+	uint8_t       release;
+}evr_s;
+
+unsigned evr_segments(const char* version);
+void evr_parse(evr_s* evr, evrSegment_s* seg, const char* version);
+evr_s* evr_arena(evr_s* evr, marena_s* arena, const char* version);
+int evr_cmp(const evr_s* a, const evr_s* b);
+int evr_cmp_epoch_version(const evr_s* a, const evr_s* b);
+int evr_order(const evr_s* a, const evr_s* b);
+int evr_vercmp(const char* a, const char* b);
+
+#endif
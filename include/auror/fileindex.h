@@ -0,0 +1,58 @@
+#ifndef __FILEINDEX_H__
+#define __FILEINDEX_H__
+
+#include <notstd/core.h>
+
+#include <stdint.h>
+
+#define FILEINDEX_MAGIC    "AURFIDX"
+#define FILEINDEX_VERSION  1
+#define FILEINDEX_BLOCK    32
+#define FILEINDEX_PATH_MAX 4096
+
+//paths are sorted and front coded, each block start with a full path
+//entry: varint shared prefix, varint suffix len, suffix, varint package id
+typedef struct fileindexHeader{
+	char     magic[8];
+	uint32_t version;
+	uint32_t count;
+	uint32_t npkg;
+	uint32_t nblock;
+	uint64_t pkgs;
+	uint64_t blocks;
+	uint64_t data;
+	uint64_t names;
+	uint64_t size;
+}fileindexHeader_s;
+
+//packages are sorted by name, name is the directory in local database
+typedef struct fileindexPkg{
+	uint64_t mtime;
+	uint32_t name;
+	uint32_t count;
+}fileindexPkg_s;
+
+typedef struct fileindex{
+	void*              map;
+	size_t             size;
+	int                mapped;
+	fileindexHeader_s* hdr;
+	fileindexPkg_s*    pkgs;
+	uint32_t*          blocks;
+	uint8_t*           data;
+	char*              names;
+}fileindex_s;
+
+//directory of package in local database, pacman rewrite files when package change
+typedef struct fileindexDir{
+	char*    name;
+	uint64_t mtime;
+}fileindexDir_s;
+
+fileindex_s* fileindex_open(const char* path);
+fileindex_s* fileindex_update(const char* path, const char* localDir, fileindexDir_s* dirs);
+const char* fileindex_pkg_name(fileindex_s* fi, unsigned id);
+unsigned fileindex_owner(fileindex_s* fi, const char* path, unsigned* owner, unsigned max);
+char* fileindex_path(const char* root, const char* path);
+
+#endif
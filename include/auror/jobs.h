@@ -5,10 +5,15 @@
 #include <notstd/threads.h>
 
 typedef void(*job_f)(void* arg);
+typedef struct jobGroup jobGroup_s;
 
 void job_begin(unsigned count);
 void job_new(job_f j, void* arg, int waitable);
 void job_wait(void);
+unsigned job_count(void);
+jobGroup_s* job_group_new(unsigned count);
+void job_group_add(jobGroup_s* group, job_f j, void* arg);
+void job_group_wait(jobGroup_s* group);
 void job_end(void);
 
 
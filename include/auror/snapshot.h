@@ -0,0 +1,81 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include <notstd/core.h>
+
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC   "AURSNAP"
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_NONE    UINT32_MAX
+
+//key of the .db used for build the snapshot, the tail is the last 8 bytes of file, gzip store crc32 and isize
+//mtime is not used, it is touched on sync also when the content not change
+typedef struct snapshotKey{
+	uint64_t size;
+	uint64_t tail;
+}snapshotKey_s;
+
+//tar entry used for build a record, on refresh unchanged entries reuse the record
+typedef struct snapshotEntry{
+	uint32_t path;
+	uint32_t crc;
+	uint32_t size;
+	uint32_t record;
+}snapshotEntry_s;
+
+typedef struct snapshotHeader{
+	char          magic[8];
+	uint32_t      version;
+	uint32_t      count;
+	snapshotKey_s key;
+	uint64_t      fields;
+	uint64_t      entries;
+	uint64_t      records;
+	uint64_t      strings;
+	uint64_t      size;
+}snapshotHeader_s;
+
+typedef struct snapshot{
+	void*             map;
+	size_t            size;
+	snapshotHeader_s* hdr;
+	const char*       fields;
+	snapshotEntry_s*  entries;
+	const uint32_t*   records;
+	char*             strings;
+	uint32_t*         sorted;
+	size_t            words;
+	size_t            strsize;
+}snapshot_s;
+
+typedef struct snapshotWriter{
+	uint32_t*        words;
+	char*            strings;
+	char*            fields;
+	snapshotEntry_s* entries;
+	uint32_t         count;
+}snapw_s;
+
+int snapshot_key(snapshotKey_s* key, const char* dbpath);
+snapshot_s* snapshot_map(const char* path);
+int snapshot_check_key(snapshot_s* snap, const char* dbpath);
+const char* snapshot_field_name(snapshot_s* snap, unsigned id);
+void snapshot_entry_index(snapshot_s* snap);
+const uint32_t* snapshot_entry_find(snapshot_s* snap, const char* path, uint32_t crc, uint32_t size);
+
+snapw_s* snapw_ctor(snapw_s* sw);
+void snapw_dtor(void* psw);
+void snapw_field(snapw_s* sw, const char* name);
+void snapw_word(snapw_s* sw, uint32_t w);
+void snapw_u64(snapw_s* sw, uint64_t v);
+void snapw_str(snapw_s* sw, const char* str);
+void snapw_strn(snapw_s* sw, const char* str, unsigned len);
+void snapw_entry(snapw_s* sw, const char* path, uint32_t crc, uint32_t size);
+int snapw_store(snapw_s* sw, const char* path, const char* dbpath);
+
+uint64_t snapshot_u64(const uint32_t* w);
+char* snapshot_str(snapshot_s* snap, uint32_t off);
+int snapshot_str_valid(snapshot_s* snap, uint32_t off);
+
+#endif
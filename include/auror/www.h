@@ -11,9 +11,12 @@
 #endif
 
 #define DOWNLOAD_RETRY_TIME 500
+#define WWW_NOT_MODIFIED    1
 
 typedef void (*wwwprogress_f)(void* ctx, double perc, double speed, unsigned long eta);
 typedef size_t (*wwwDownload_f)(void* ptr, size_t size, size_t nmemb, void* userctx);
+//called before retry of a failed perform, not 0 abort the retries
+typedef int (*wwwRestart_f)(void* ctx);
 
 typedef struct www{
 	__prv8 CURL* curl;
@@ -24,6 +27,9 @@ typedef struct www{
 	__prv8 void* progctx;
 	__prv8 unsigned long holdeta; 
 	__prv8 char* resturl;
+	__prv8 struct curl_slist* header;
+	__prv8 wwwRestart_f restart;
+	__prv8 void* restartctx;
 }www_s;
 
 typedef struct restret{
@@ -44,6 +50,7 @@ char* url_escape(const char* url);
 
 void www_dtor(void* pw);
 www_s* www_ctor(www_s* w, const char* url, unsigned retry, delay_t relaxms);
+//0 success, WWW_NOT_MODIFIED on http 304, -1 error
 int www_perform(www_s* w);
 char* www_real_url(www_s* w);
 void www_timeout(www_s* w, unsigned sec);
@@ -51,6 +58,10 @@ void www_header_body(www_s* w, int header, int body);
 void www_download_mem(www_s* w, uint8_t** out);
 void www_download_file(www_s* w, FILE* f);
 void www_download_custom(www_s* w, wwwDownload_f fn, void* ctx);
+void www_header_add(www_s* w, const char* header);
+void www_header_custom(www_s* w, wwwDownload_f fn, void* ctx);
+//called before each retry, custom download must discard data received from failed transfer
+void www_restart_custom(www_s* w, wwwRestart_f fn, void* ctx);
 void www_progress(www_s* w, wwwprogress_f fn, void* ctx);
 void www_restapi(www_s* w, const char* url);
 restret_s www_restapi_call(www_s* w, const char* args);
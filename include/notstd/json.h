@@ -58,4 +58,8 @@ int json_decode_partial(jvalue_s* out, const char** par, const char** err);
 jvalue_s* json_decode(const char* str, const char** endstr, const char **outErr);
 char* json_encode(jvalue_s* jv, unsigned fprec, unsigned human);
 
+char* json_scan_ws(char* parse);
+char* json_scan_string(char** par, const char** err);
+int json_scan_skip(char** par, const char** err);
+
 #endif
@@ -111,6 +111,28 @@ void mem_free(void* addr);
 //not use this, this is used for __free
 void mem_free_raii(void* addr);
 
+//arena, memory returned is compatible with mem_* functions but is released only when the arena is freed
+//mem_free of arena memory call cleanup, mem_realloc move memory out of arena, alloc is thread safe
+#define AMANY(A,T,C) (T*)marena_alloc((A), sizeof(T), (C))
+#define ANEW(A,T)    AMANY(A,T,1)
+
+typedef struct marenaChunk{
+	struct marenaChunk* next;
+	size_t              size;
+	size_t              used;
+}marenaChunk_s;
+
+typedef struct marena{
+	marenaChunk_s* current;
+	marenaChunk_s* full;
+	size_t         chunk;
+}marena_s;
+
+//is a mem_alloc object, free with mem_free
+marena_s* marena_new(size_t chunk);
+
+__malloc void* marena_alloc(marena_s* arena, unsigned sof, size_t count);
+
 //lock memory for read, all threads can read but nobody can write
 int mem_lock_read(void* addr);
 //lock memory for writing, wait all threads stop reading, only one can write
@@ -15,7 +15,7 @@ typedef struct rhElement{
 	__rdwr void*    data;     /**< user data*/
 	__rdon uint64_t hash;     /**< hash */
 	__rdon uint32_t len;      /**< len of key*/
-	__prv8 uint32_t distance; /**< distance from hash*/
+	__prv8 uint32_t distance; /**< distance from hash + 1, 0 is free bucket*/
 	__rdon char     key[];    /**< flexible key*/
 }rhElement_s;
 
@@ -24,13 +24,14 @@ typedef struct rhhash{
 	__rdon unsigned pmin;        /**< percentage elements of free bucket*/
 	__rdon unsigned min;         /**< min elements of free bucket*/
 	__rdon unsigned maxdistance; /**< max distance from hash*/
-	__rdon unsigned keySize;     /**< key size*/
-	__rdon unsigned size;
+	__rdon unsigned keySize;     /**< key size, 0 store only pointer to key*/
+	__rdon unsigned size;        /**< buckets, always power of 2*/
+	__rdon unsigned count;       /**< elements in table*/
+	__prv8 unsigned esize;       /**< size of element with key*/
+	__prv8 rhElement_s* swap;    /**< two elements used on insert*/
 	__rdon rhhash_f hashing;     /**< function calcolate hash*/
 }rhhash_s;
 
-typedef uint64_t(*rhhash_f)(const void* name, size_t len);
-
 /************/
 /* rhhash.c */
 /************/
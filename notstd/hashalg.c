@@ -0,0 +1,179 @@
+#include <notstd/hashalg.h>
+
+uint64_t hash_one_at_a_time(const void *key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 0;
+	for( size_t i = 0; i < len; ++i ){
+		h += p[i];
+		h += (h << 10);
+		h ^= (h >> 6);
+	}
+	h += (h << 3);
+	h ^= (h >> 11);
+	h += (h << 15);
+	return h;
+}
+
+#define fasthash_mix(h) ({\
+	(h) ^= (h) >> 23;\
+	(h) *= 0x2127599bf4325c37ULL;\
+	(h) ^= (h) >> 47;\
+})
+
+uint64_t hash_fasthash(const void* key, size_t len){
+	const uint64_t m = 0x880355f21e6d1965ULL;
+	const uint64_t seed = 0xCAFEBABEDEADBEEFULL;
+	const unsigned char* p = key;
+	const unsigned char* end = p + (len & ~(size_t)7);
+	uint64_t h = seed ^ (len * m);
+	uint64_t v;
+
+	for( ; p < end; p += 8 ){
+		memcpy(&v, p, sizeof v);
+		h ^= fasthash_mix(v);
+		h *= m;
+	}
+
+	v = 0;
+	switch( len & 7 ){
+		case 7: v ^= (uint64_t)p[6] << 48; __fallthrough;
+		case 6: v ^= (uint64_t)p[5] << 40; __fallthrough;
+		case 5: v ^= (uint64_t)p[4] << 32; __fallthrough;
+		case 4: v ^= (uint64_t)p[3] << 24; __fallthrough;
+		case 3: v ^= (uint64_t)p[2] << 16; __fallthrough;
+		case 2: v ^= (uint64_t)p[1] << 8;  __fallthrough;
+		case 1: v ^= (uint64_t)p[0];
+			h ^= fasthash_mix(v);
+			h *= m;
+	}
+
+	return fasthash_mix(h);
+}
+
+uint64_t hash_kr(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 0;
+	for( size_t i = 0; i < len; ++i ){
+		h = p[i] + 31 * h;
+	}
+	return h;
+}
+
+uint64_t hash_sedgewicks(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t a = 63689;
+	const uint64_t b = 378551;
+	uint64_t h = 0;
+	for( size_t i = 0; i < len; ++i ){
+		h = h * a + p[i];
+		a *= b;
+	}
+	return h;
+}
+
+uint64_t hash_sobel(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 1315423911;
+	for( size_t i = 0; i < len; ++i ){
+		h ^= ((h << 5) + p[i] + (h >> 2));
+	}
+	return h;
+}
+
+uint64_t hash_weinberger(const void* key, size_t len){
+	const unsigned char* p = key;
+	const unsigned bits = sizeof(uint64_t) * 8;
+	const unsigned threequarters = (bits * 3) / 4;
+	const unsigned oneeighth = bits / 8;
+	const uint64_t highbits = (uint64_t)(0xFFFFFFFFFFFFFFFFULL) << (bits - oneeighth);
+	uint64_t h = 0;
+	uint64_t test;
+	for( size_t i = 0; i < len; ++i ){
+		h = (h << oneeighth) + p[i];
+		if( (test = h & highbits) != 0 ){
+			h = ((h ^ (test >> threequarters)) & (~highbits));
+		}
+	}
+	return h;
+}
+
+uint64_t hash_elf(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 0;
+	uint64_t x;
+	for( size_t i = 0; i < len; ++i ){
+		h = (h << 4) + p[i];
+		if( (x = h & 0xF0000000UL) != 0 ){
+			h ^= (x >> 24);
+		}
+		h &= ~x;
+	}
+	return h;
+}
+
+uint64_t hash_sdbm(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 0;
+	for( size_t i = 0; i < len; ++i ){
+		h = p[i] + (h << 6) + (h << 16) - h;
+	}
+	return h;
+}
+
+uint64_t hash_bernstein(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 5381;
+	for( size_t i = 0; i < len; ++i ){
+		h = ((h << 5) + h) + p[i];
+	}
+	return h;
+}
+
+uint64_t hash_knuth(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = len;
+	for( size_t i = 0; i < len; ++i ){
+		h = ((h << 5) ^ (h >> 27)) ^ p[i];
+	}
+	return h;
+}
+
+uint64_t hash_partow(const void* key, size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 0xAAAAAAAA;
+	for( size_t i = 0; i < len; ++i ){
+		h ^= (i & 1) == 0 ? ((h << 7) ^ p[i] * (h >> 3)) : (~((h << 11) + (p[i] ^ (h >> 5))));
+	}
+	return h;
+}
+
+uint64_t hash64_splitmix(const void* key, __unused size_t len){
+	uint64_t z;
+	memcpy(&z, key, sizeof z);
+	z += 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+uint64_t hash_murmur_oaat64(const void* key, const size_t len){
+	const unsigned char* p = key;
+	uint64_t h = 525201411107845655ULL;
+	for( size_t i = 0; i < len; ++i ){
+		h ^= p[i];
+		h *= 0x5BD1E9955BD1E995ULL;
+		h ^= h >> 47;
+	}
+	return h;
+}
+
+uint64_t hash_murmur_oaat32(const void* key, const size_t len){
+	const unsigned char* p = key;
+	uint32_t h = 3323198485UL;
+	for( size_t i = 0; i < len; ++i ){
+		h ^= p[i];
+		h *= 0x5BD1E995;
+		h ^= h >> 15;
+	}
+	return h;
+}
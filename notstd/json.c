@@ -602,6 +602,145 @@ jvalue_s* json_decode(const char* str, const char** endstr, const char **outErr)
 	return NULL;
 }
 
+char* json_scan_ws(char* parse){
+	while( *parse == ' ' || *parse == '\t' || *parse == '\n' || *parse == '\r' ) ++parse;
+	return parse;
+}
+
+//unescaped string is never longer than json string, is write and terminated inside buffer
+char* json_scan_string(char** par, const char** err){
+	char* parse = *par;
+	if( *parse != '"' ){
+		*err = "string not begin with \"";
+		return NULL;
+	}
+	char* str = ++parse;
+	parse += strcspn(parse, "\"\\\n\r\t\b\f");
+	char* w = parse;
+	while( *parse != '"' ){
+		switch( *parse ){
+			case 0:
+				*err = "unterminated string";
+				*par = parse;
+			return NULL;
+			
+			case '\n': case '\r': case '\t': case '\b': case '\f':
+				*err = "newline, tab, etc need escape in string";
+				*par = parse;
+			return NULL;
+			
+			case '\\':{
+				++parse;
+				switch( *parse ){
+					default  : *par = parse; *err = "invalid escape"; return NULL;
+					case '\\': *w++ = '\\'; ++parse; break;
+					case '/' : *w++ = '/'; ++parse; break;
+					case '"' : *w++ = '"'; ++parse; break;
+					case 'b' : *w++ = '\b'; ++parse; break;
+					case 'f' : *w++ = '\f'; ++parse; break;
+					case 'n' : *w++ = '\n'; ++parse; break;
+					case 'r' : *w++ = '\r'; ++parse; break;
+					case 't' : *w++ = '\t'; ++parse; break;
+					case 'u' :{
+						const char* u = parse + 1;
+						*err = NULL;
+						ucs4_t u4 = json_escape_unicode(&u, err);
+						if( *err ){
+							*par = (char*)u;
+							return NULL;
+						}
+						if( u4 >= 0xD800 && u4 <= 0xDFFF ){
+							if( !(u[0] == '\\' && u[1] == 'u') ){
+								*err = "invalid unicode, aspeted surrugate";
+								*par = (char*)u;
+								return NULL;
+							}
+							u += 2;
+							ucs4_t surrugate = json_escape_unicode(&u, err);
+							if( *err || !(surrugate >= 0xDC00 && surrugate <= 0xDFFF) ){
+								*err = "invalid unicode surrugate";
+								*par = (char*)u;
+								return NULL;
+							}
+							u4 = ((u4 & 0x3ff) << 10) + (surrugate & 0x3ff) + 0x10000;
+						}
+						if( !u4 || u4 > 0x10FFFF ){
+							*err = "invalid unicode";
+							*par = (char*)u;
+							return NULL;
+						}
+						w += ucs4_to_utf8(u4, (utf8_t*)w);
+						parse = (char*)u;
+					}
+					break;
+				}
+			}
+			break;
+			
+			default:
+				*w++ = *parse++;
+			break;
+		}
+		const size_t n = strcspn(parse, "\"\\\n\r\t\b\f");
+		memmove(w, parse, n);
+		w += n;
+		parse += n;
+	}
+	*w = 0;
+	*par = parse + 1;
+	return str;
+}
+
+//skip any value without decode, used for not required properties
+int json_scan_skip(char** par, const char** err){
+	char* parse = *par;
+	unsigned deep = 0;
+	do{
+		parse = json_scan_ws(parse);
+		switch( *parse ){
+			case '{': case '[': ++deep; ++parse; continue;
+			case ',': case ':':
+				if( !deep ) goto ONERR;
+				++parse;
+			continue;
+			
+			case '}': case ']':
+				if( !deep ) goto ONERR;
+				--deep;
+				++parse;
+			break;
+			
+			case '"':
+				if( !json_scan_string(&parse, err) ){
+					*par = parse;
+					return -1;
+				}
+			break;
+			
+			case 't': if( strncmp(parse, "true", 4) ) goto ONERR; parse += 4; break;
+			case 'f': if( strncmp(parse, "false", 5) ) goto ONERR; parse += 5; break;
+			case 'n': if( strncmp(parse, "null", 4) ) goto ONERR; parse += 4; break;
+			
+			default:{
+				const char* num = parse;
+				if( json_parse_validate_num(&num, err) == JV_ERR ){
+					*par = (char*)num;
+					return -1;
+				}
+				if( num == parse ) goto ONERR;
+				parse = (char*)num;
+			}
+			break;
+		}
+	}while( deep );
+	*par = parse;
+	return 0;
+ONERR:
+	*err = "invalid charater, aspected element(num, string, array or object)";
+	*par = parse;
+	return -1;
+}
+
 void jvalue_dump(jvalue_s* jv){
 	switch( jv->type ){
 		default: die("internal error, report this issue, %d but not supported", jv->type); break;
@@ -14,6 +14,7 @@
 #include <notstd/threads.h>
 
 #define HMEM_FLAG_CHECK    0xF1CA
+#define HMEM_FLAG_ARENA    0x10000
 #define HMEM_CHECK(HM)     (((HM)->flags & 0xFFFF) == HMEM_FLAG_CHECK)
 #define HMEM_TO_ADDR(HM)   ((void*)(ADDR(HM)+sizeof(hmem_s)))
 #define ADDR_TO_HMEM(A)    ((hmem_s*)(ADDR(A)-sizeof(hmem_s)))
@@ -79,8 +80,18 @@ void* mem_realloc(void* mem, size_t count){
 	size  = ROUND_UP(size, sizeof(uintptr_t));
 	dbg_info("realloc to %lu", size);
 
-	hm = realloc(hm, size);
-	if( !hm ) die("on realloc: %m");
+	if( hm->flags & HMEM_FLAG_ARENA ){
+		hmem_s* ahm = hm;
+		hm = malloc(size);
+		if( !hm ) die("on malloc: %m");
+		memcpy(hm, ahm, ahm->size < size ? ahm->size : size);
+		hm->flags &= ~HMEM_FLAG_ARENA;
+		mrw_ctor(&hm->lock);
+	}
+	else{
+		hm = realloc(hm, size);
+		if( !hm ) die("on realloc: %m");
+	}
 	hm->size = size;
 
 	void* ret = HMEM_TO_ADDR(hm);
@@ -271,13 +282,91 @@ void mem_free(void* addr){
 	iassert( hm->refs );
 	if( --hm->refs ) return;
 	if( hm->cleanup ) hm->cleanup(HMEM_TO_ADDR(hm));
-	free(hm);
+	if( !(hm->flags & HMEM_FLAG_ARENA) ) free(hm);
 }
 
 void mem_free_raii(void* addr){
 	mem_free(*(void**)addr);
 }
 
+__private void marena_chunk_free(marenaChunk_s* c){
+	while( c ){
+		marenaChunk_s* next = c->next;
+		free(c);
+		c = next;
+	}
+}
+
+__private void marena_cleanup(void* parena){
+	marena_s* arena = parena;
+	marena_chunk_free(arena->current);
+	marena_chunk_free(arena->full);
+}
+
+__private marenaChunk_s* marena_chunk(size_t size, size_t used){
+	marenaChunk_s* c = malloc(sizeof(marenaChunk_s) + size);
+	if( !c ) die("on malloc: %m");
+	c->next = NULL;
+	c->size = size;
+	c->used = used;
+	return c;
+}
+
+marena_s* marena_new(size_t chunk){
+	marena_s* arena = mem_alloc(sizeof(marena_s), 1, marena_cleanup);
+	arena->chunk   = ROUND_UP(chunk, sizeof(uintptr_t));
+	arena->current = marena_chunk(arena->chunk, 0);
+	arena->full    = NULL;
+	return arena;
+}
+
+__private void marena_push_full(marena_s* arena, marenaChunk_s* c){
+	c->next = __atomic_load_n(&arena->full, __ATOMIC_RELAXED);
+	while( !__atomic_compare_exchange_n(&arena->full, &c->next, c, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED) );
+}
+
+//bump pointer on current chunk, on overflow the thread that swap the chunk move the old to full list
+__private void* marena_bump(marena_s* arena, size_t size){
+	while( 1 ){
+		marenaChunk_s* c = __atomic_load_n(&arena->current, __ATOMIC_ACQUIRE);
+		size_t off = __atomic_fetch_add(&c->used, size, __ATOMIC_RELAXED);
+		if( off + size <= c->size ) return (void*)(ADDR(c) + sizeof(marenaChunk_s) + off);
+		marenaChunk_s* n = marena_chunk(arena->chunk, 0);
+		if( __atomic_compare_exchange_n(&arena->current, &c, n, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ){
+			marena_push_full(arena, c);
+		}
+		else{
+			free(n);
+		}
+	}
+}
+
+__malloc void* marena_alloc(marena_s* arena, unsigned sof, size_t count){
+	iassert(sof);
+	iassert(count);
+	size_t size = sof * count + sizeof(hmem_s);
+	size = ROUND_UP(size, sizeof(uintptr_t));
+	hmem_s* hm;
+	if( size > arena->chunk / 4 ){
+		marenaChunk_s* c = marena_chunk(size, size);
+		marena_push_full(arena, c);
+		hm = (hmem_s*)(ADDR(c) + sizeof(marenaChunk_s));
+	}
+	else{
+		hm = marena_bump(arena, size);
+	}
+	hm->refs    = 1;
+	hm->flags   = HMEM_FLAG_CHECK | HMEM_FLAG_ARENA;
+	hm->size    = size;
+	hm->cleanup = NULL;
+	hm->len     = 0;
+	hm->sof     = sof;
+	mrw_ctor(&hm->lock);
+	void* ret = HMEM_TO_ADDR(hm);
+	iassert( ADDR(ret) % sizeof(uintptr_t) == 0 );
+	return ret;
+}
+
 int mem_lock_read(void* addr){
 	mrw_read(&givehm(addr)->lock);
 	return 1;
@@ -0,0 +1,184 @@
+#define RHHASH_IMPLEMENTATION
+#include <notstd/rhhash.h>
+
+#define RH_DEFAULT_SIZE 16
+
+#define rh_element(RBH, B) ((rhElement_s*)((char*)(RBH)->table + (size_t)(B) * (RBH)->esize))
+
+__private unsigned rh_pow2(unsigned size){
+	unsigned p = RH_DEFAULT_SIZE;
+	while( p < size ) p <<= 1;
+	return p;
+}
+
+__private rhElement_s* rh_table(unsigned size, unsigned esize){
+	rhElement_s* table = (rhElement_s*)MANY(char, (size_t)size * esize);
+	memset(table, 0, (size_t)size * esize);
+	return table;
+}
+
+__private const void* rh_key(rhhash_s* rbh, rhElement_s* e){
+	if( rbh->keySize ) return e->key;
+	const void* key;
+	memcpy(&key, e->key, sizeof key);
+	return key;
+}
+
+__private int rh_match(rhhash_s* rbh, rhElement_s* e, uint64_t hash, const void* key, size_t len){
+	return e->hash == hash && e->len == len && !memcmp(rh_key(rbh, e), key, len);
+}
+
+rhhash_s* rhhash_ctor(rhhash_s* rbh, unsigned size, unsigned min, unsigned keysize, rhhash_f hashing){
+	rbh->size        = rh_pow2(size);
+	rbh->pmin        = min ? min : 10;
+	rbh->min         = (rbh->size * rbh->pmin) / 100 + 1;
+	rbh->maxdistance = 0;
+	rbh->count       = 0;
+	rbh->keySize     = keysize;
+	rbh->esize       = ROUND_UP(sizeof(rhElement_s) + (keysize ? keysize : sizeof(void*)), sizeof(void*));
+	rbh->hashing     = hashing ? hashing : hash_fasthash;
+	rbh->table       = rh_table(rbh->size, rbh->esize);
+	rbh->swap        = rh_table(2, rbh->esize);
+	return rbh;
+}
+
+void rhhash_dtor(void* rbh){
+	rhhash_s* h = rbh;
+	mem_free(h->table);
+	mem_free(h->swap);
+	h->table = NULL;
+	h->swap  = NULL;
+}
+
+//robin hood, who is more far from home take the bucket
+__private void rh_insert(rhhash_s* rbh, rhElement_s* in){
+	const unsigned mask = rbh->size - 1;
+	rhElement_s* tmp = (rhElement_s*)((char*)rbh->swap + rbh->esize);
+	unsigned bucket = in->hash & mask;
+	in->distance = 1;
+	while( 1 ){
+		rhElement_s* e = rh_element(rbh, bucket);
+		if( !e->distance ){
+			memcpy(e, in, rbh->esize);
+			if( in->distance > rbh->maxdistance ) rbh->maxdistance = in->distance;
+			++rbh->count;
+			return;
+		}
+		if( e->distance < in->distance ){
+			if( in->distance > rbh->maxdistance ) rbh->maxdistance = in->distance;
+			memcpy(tmp, e, rbh->esize);
+			memcpy(e, in, rbh->esize);
+			memcpy(in, tmp, rbh->esize);
+		}
+		++in->distance;
+		bucket = (bucket + 1) & mask;
+	}
+}
+
+__private void rh_grow(rhhash_s* rbh){
+	rhElement_s* old = rbh->table;
+	const unsigned oldsize = rbh->size;
+	rbh->size <<= 1;
+	rbh->min         = (rbh->size * rbh->pmin) / 100 + 1;
+	rbh->maxdistance = 0;
+	rbh->count       = 0;
+	rbh->table       = rh_table(rbh->size, rbh->esize);
+	rhhash_s view = { .table = old, .esize = rbh->esize };
+	for( unsigned i = 0; i < oldsize; ++i ){
+		rhElement_s* e = rh_element(&view, i);
+		if( e->distance ) rh_insert(rbh, e);
+	}
+	mem_free(old);
+}
+
+__private int rh_add(rhhash_s* rbh, uint64_t hash, const void* key, size_t len, void* data){
+	if( rbh->keySize && len > rbh->keySize ) return -1;
+	if( rbh->size - rbh->count <= rbh->min ) rh_grow(rbh);
+	rhElement_s* in = rbh->swap;
+	memset(in, 0, rbh->esize);
+	in->data = data;
+	in->hash = hash;
+	in->len  = len;
+	if( rbh->keySize ) memcpy(in->key, key, len);
+	else memcpy(in->key, &key, sizeof key);
+	rh_insert(rbh, in);
+	return 0;
+}
+
+int rhhash_addh(rhhash_s* rbh, uint64_t hash, const void* key, size_t len, void* data){
+	return rh_add(rbh, hash, key, len, data);
+}
+
+int rhhash_add(rhhash_s* rbh, const void* key, size_t len, void* data){
+	return rh_add(rbh, rbh->hashing(key, len), key, len, data);
+}
+
+long rhhash_find_bucket(rhhash_s* rbh, uint64_t hash, const void* key, size_t len){
+	const unsigned mask = rbh->size - 1;
+	unsigned bucket = hash & mask;
+	for( unsigned distance = 1; distance <= rbh->maxdistance; ++distance ){
+		rhElement_s* e = rh_element(rbh, bucket);
+		if( e->distance < distance ) return -1;
+		if( rh_match(rbh, e, hash, key, len) ) return bucket;
+		bucket = (bucket + 1) & mask;
+	}
+	return -1;
+}
+
+unsigned rhhash_bucket_next(rhhash_s* rbh, unsigned bucket){
+	while( bucket < rbh->size && !rh_element(rbh, bucket)->distance ) ++bucket;
+	return bucket;
+}
+
+int rhhash_addu(rhhash_s* rbh, const void* key, size_t len, void* data){
+	const uint64_t hash = rbh->hashing(key, len);
+	if( rhhash_find_bucket(rbh, hash, key, len) >= 0 ) return -1;
+	return rh_add(rbh, hash, key, len, data);
+}
+
+rhElement_s* rhhash_findh(rhhash_s* rbh, uint64_t hash, const void* key, size_t len){
+	const long bucket = rhhash_find_bucket(rbh, hash, key, len);
+	return bucket < 0 ? NULL : rh_element(rbh, bucket);
+}
+
+rhElement_s* rhhash_find(rhhash_s* rbh, const void* key, size_t len){
+	return rhhash_findh(rbh, rbh->hashing(key, len), key, len);
+}
+
+//backward shift, no tombstone
+int rhhash_removeh(rhhash_s* rbh, uint64_t hash, const void* key, size_t len){
+	const long found = rhhash_find_bucket(rbh, hash, key, len);
+	if( found < 0 ) return -1;
+	const unsigned mask = rbh->size - 1;
+	unsigned bucket = found;
+	while( 1 ){
+		const unsigned next = (bucket + 1) & mask;
+		rhElement_s* e = rh_element(rbh, bucket);
+		rhElement_s* n = rh_element(rbh, next);
+		if( n->distance < 2 ){
+			memset(e, 0, rbh->esize);
+			break;
+		}
+		memcpy(e, n, rbh->esize);
+		--e->distance;
+		bucket = next;
+	}
+	--rbh->count;
+	return 0;
+}
+
+int rhhash_remove(rhhash_s* ht, const void* key, size_t len){
+	return rhhash_removeh(ht, ht->hashing(key, len), key, len);
+}
+
+unsigned rhhash_bucket_used(rhhash_s* rbh){
+	return rbh->count;
+}
+
+unsigned rhhash_collision(rhhash_s* rbh){
+	unsigned count = 0;
+	for( unsigned i = 0; i < rbh->size; ++i ){
+		if( rh_element(rbh, i)->distance > 1 ) ++count;
+	}
+	return count;
+}
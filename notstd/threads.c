@@ -22,7 +22,7 @@ int mutex_lock(mutex_t* mtx){
 		do{
 			CAS_B(mtx, 1, 2);
 			futex_wait_private(mtx, 2);
-		}while( !CAS_WL(mtx, 0, 2) );
+		}while( !CAS_WA(mtx, 0, 2) );
 	}
 	return 1;
 }
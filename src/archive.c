@@ -5,6 +5,15 @@
 
 #include <archive.h>
 #include <zstd.h>
+#ifdef INFLATE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+#include <endian.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//max zstd frame header, gzip need less
+#define DECOMPRESS_HEADER_MAX 18
 
 gzip_t* gzip_ctor(gzip_t* gz){
 	memset(gz, 0, sizeof(gzip_t));
@@ -17,49 +26,50 @@ void gzip_dtor(gzip_t* gz){
 	inflateEnd(gz);
 }
 
-int gzip_decompress(gzip_t* gz, void* data, size_t size){
-	size_t framesize = size * 6;
-	char* dec = (char*)gz->next_out;
-	if( !dec ){
-		dec = MANY(char, framesize);
-	}
-	else{
-		dec = mem_upsize(dec, framesize);
-	}
-	
-	gz->avail_in  = size;
-	gz->next_in   = (Bytef*)data;
-	gz->next_out  = (Bytef*)(dec + *mem_len(dec));
-	gz->avail_out = framesize;
-	
-	int ret;
-	do{
-		if( (ret=inflate(gz, Z_NO_FLUSH)) == Z_ERRNO ){
-			mem_free(dec);
-			gz->next_out = NULL;
-			errno = EIO;
-			dbg_error("decompression failed");
-			return -1;
+decompress_e decompress_sniff(const void* data, size_t size){
+	const uint8_t* d = data;
+	if( size >= 2 && d[0] == 0x1f && d[1] == 0x8b ) return DECOMPRESS_GZIP;
+	if( size >= 4 && d[0] == 0x28 && d[1] == 0xb5 && d[2] == 0x2f && d[3] == 0xfd ) return DECOMPRESS_ZSTD;
+	return DECOMPRESS_UNKNOW;
+}
+
+//gzip trailer store uncompressed size modulo 2^32, zstd can store it in frame header, 0 if unknow
+size_t decompress_file_size(int fd){
+	struct stat st;
+	uint8_t head[DECOMPRESS_HEADER_MAX];
+	if( fstat(fd, &st) || st.st_size < 18 ) return 0;
+	if( pread(fd, head, sizeof head, 0) != sizeof head ) return 0;
+	switch( decompress_sniff(head, sizeof head) ){
+		case DECOMPRESS_GZIP:{
+			uint32_t isize;
+			if( pread(fd, &isize, sizeof isize, st.st_size - sizeof isize) != sizeof isize ) return 0;
+			return le32toh(isize);
 		}
-		//if( ++n == 5 ) die("");
-		mem_header(dec)->len += framesize - gz->avail_out;
-		if( gz->avail_out == 0 ){
-			dec           = mem_upsize(dec, framesize);
-			framesize     = mem_available(dec);
-			gz->avail_out = framesize;
+		case DECOMPRESS_ZSTD:{
+			unsigned long long size = ZSTD_getFrameContentSize(head, sizeof head);
+			return size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR ? 0 : size;
 		}
-		gz->next_out  = (Bytef*)(mem_addressing(dec, mem_header(dec)->len));
-	}while( ret != Z_STREAM_END && (ret == 0 && gz->avail_in != 0));
-	gz->next_out = (Bytef*)dec;
-	return ret == Z_STREAM_END ? 0 : 1;
+		default: return 0;
+	}
 }
 
-void* gzip_decompress_all(void* data) {
+//0 when trailer is not usable, the caller must grow the buffer
+__private size_t gzip_mem_isize(void* data, size_t size){
+	const uint8_t* d = data;
+	uint32_t isize;
+	if( size < 18 || d[0] != 0x1f || d[1] != 0x8b ) return 0;
+	memcpy(&isize, &d[size - sizeof isize], sizeof isize);
+	return le32toh(isize);
+}
+
+__private void* zlib_decompress_all(void* data) {
 	z_stream strm;
 	memset(&strm, 0, sizeof(strm));
 	if( inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK ) die("Unable to initialize zlib");
 	size_t datasize = mem_header(data)->len;
-	size_t framesize = datasize * 2;
+	const size_t isize = gzip_mem_isize(data, datasize);
+	//one byte more, an exact trailer end the stream without touch the buffer again
+	size_t framesize = isize >= datasize ? isize + 1 : datasize * 2;
 	void* dec = MANY(char, framesize);
 	
 	strm.avail_in  = datasize;
@@ -69,14 +79,17 @@ void* gzip_decompress_all(void* data) {
 	
 	int ret;
 	do{
-		if( (ret=inflate(&strm, Z_NO_FLUSH)) == Z_ERRNO ){
+		ret = inflate(&strm, Z_NO_FLUSH);
+		if( ret != Z_OK && ret != Z_STREAM_END && !(ret == Z_BUF_ERROR && strm.avail_in) ){
 			mem_free(dec);
+			inflateEnd(&strm);
 			errno = EIO;
 			dbg_error("decompression failed");
 			return NULL;
 		}
 		mem_header(dec)->len += framesize - strm.avail_out;
 		if (strm.avail_out == 0) {
+			dbg_warning("gzip isize not match, grow buffer");
 			dec = mem_upsize(dec, framesize);
 			framesize = mem_available(dec);
 			strm.avail_out = framesize;
@@ -88,9 +101,9 @@ void* gzip_decompress_all(void* data) {
 	return dec;
 }
 
-void* zstd_decompress(void* data){
+//output grow of chunk bytes, decompress until last frame is flushed, NULL if data is truncated
+void* zstd_decompress_chunked(void* data, size_t chunk){
 	const size_t isize = mem_header(data)->len;
-	const size_t chunk = ZSTD_DStreamOutSize();
 	char* buf = MANY(char, chunk);
 	ZSTD_DCtx* const dctx = ZSTD_createDCtx();
 	if( !dctx ) die("unable to create zstd ctx");
@@ -100,19 +113,97 @@ void* zstd_decompress(void* data){
 		.pos  = 0
 	};
 	ZSTD_outBuffer out;
-	while( inp.pos < inp.size ){
+	size_t ret;
+	do{
 		buf = mem_upsize(buf, chunk);
 		out.dst  = &buf[mem_header(buf)->len];
 		out.size = chunk;
 		out.pos  = 0;
-		size_t const ret = ZSTD_decompressStream(dctx, &out , &inp);
-		mem_header(buf)->len += out.pos;
+		ret = ZSTD_decompressStream(dctx, &out , &inp);
 		if( ZSTD_isError(ret) ) die("zstd unable get frame: %s", ZSTD_getErrorName(ret));
-	}
+		mem_header(buf)->len += out.pos;
+		if( ret && inp.pos == inp.size && out.pos < out.size ){
+			dbg_error("zstd frame truncated");
+			mem_free(buf);
+			ZSTD_freeDCtx(dctx);
+			errno = EIO;
+			return NULL;
+		}
+	}while( ret || inp.pos < inp.size );
 	ZSTD_freeDCtx(dctx);
 	return buf;
 }
 
+__private void* zstd_stream_decompress(void* data){
+	return zstd_decompress_chunked(data, ZSTD_DStreamOutSize());
+}
+
+#ifdef INFLATE_LIBDEFLATE
+__private void* libdeflate_decompress_all(void* data){
+	const size_t datasize = mem_header(data)->len;
+	const size_t isize    = gzip_mem_isize(data, datasize);
+	size_t framesize      = isize >= datasize ? isize : datasize * 4;
+	struct libdeflate_decompressor* d = libdeflate_alloc_decompressor();
+	if( !d ) die("unable to create libdeflate decompressor");
+	char* dec = MANY(char, framesize);
+	while( 1 ){
+		size_t nw = 0;
+		enum libdeflate_result ret = libdeflate_gzip_decompress(d, data, datasize, dec, framesize, &nw);
+		if( ret == LIBDEFLATE_SUCCESS ){
+			mem_header(dec)->len = nw;
+			break;
+		}
+		if( ret != LIBDEFLATE_INSUFFICIENT_SPACE ){
+			dbg_error("decompression failed");
+			mem_free(dec);
+			libdeflate_free_decompressor(d);
+			errno = EIO;
+			return NULL;
+		}
+		dbg_warning("gzip isize not match, grow buffer");
+		dec = mem_upsize(dec, framesize);
+		framesize = mem_available(dec);
+	}
+	libdeflate_free_decompressor(d);
+	return dec;
+}
+#endif
+
+const decompressor_s DECOMPRESSORS[] = {
+#ifdef INFLATE_LIBDEFLATE
+	{ "libdeflate", DECOMPRESS_GZIP, libdeflate_decompress_all },
+#endif
+	{ "zlib"      , DECOMPRESS_GZIP, zlib_decompress_all },
+	{ "zstd"      , DECOMPRESS_ZSTD, zstd_stream_decompress },
+	{ NULL        , 0              , NULL }
+};
+
+//first backend for type is the one selected at build time
+const decompressor_s* decompressor_get(decompress_e type){
+	for( unsigned i = 0; DECOMPRESSORS[i].name; ++i ){
+		if( DECOMPRESSORS[i].type == type ) return &DECOMPRESSORS[i];
+	}
+	die("internal error, no decompressor for type %u", type);
+}
+
+void* gzip_decompress_all(void* data){
+	return decompressor_get(DECOMPRESS_GZIP)->decompress(data);
+}
+
+void* zstd_decompress(void* data){
+	return decompressor_get(DECOMPRESS_ZSTD)->decompress(data);
+}
+
+void* decompress_all(void* data){
+	const decompress_e type = decompress_sniff(data, mem_header(data)->len);
+	if( type == DECOMPRESS_UNKNOW ){
+		dbg_error("unsupported compression format");
+		errno = ENOTSUP;
+		return NULL;
+	}
+	return decompressor_get(type)->decompress(data);
+}
+
 
 #define TAR_BLK  148
 #define TAR_CHK  8
@@ -147,7 +238,11 @@ void tar_mopen(tar_s* tar, void* data){
 	tar->end    = tar->loaddr + mem_header(data)->len;
 	tar->err    = 0;
 	//dbg_info("start: %lu end: %lu tot: %lu n: %lu", tar->loaddr, tar->end, tar->end-tar->loaddr, (tar->end-tar->loaddr)/512);
-	memset(&tar->global, 0, sizeof tar->global);
+	tar->global.size     = 0;
+	tar->global.path.str = NULL;
+	tar->global.path.len = 0;
+	tar->global.link.str = NULL;
+	tar->global.link.len = 0;
 }
 
 __private unsigned tar_checksum(void* data){
@@ -166,6 +261,17 @@ __private unsigned tar_checksum(void* data){
 	return chk;
 }
 
+//octal fields are space or nul terminated and can fill all the field
+__private unsigned long tar_octal(const char* f, size_t size){
+	const char* e = f + size;
+	unsigned long v = 0;
+	while( f < e && *f == ' ' ) ++f;
+	while( f < e && *f >= '0' && *f <= '7' ) v = (v << 3) | (unsigned long)(*f++ - '0');
+	return v;
+}
+
+#define htar_octal(H, FIELD) tar_octal((H)->FIELD, sizeof (H)->FIELD)
+
 __private htar_s* htar_get(tar_s* tar){
 	if( tar->loaddr >= tar->end ){
 		dbg_error("out of tar bound");
@@ -190,7 +296,7 @@ __private htar_s* htar_get(tar_s* tar){
 		return NULL;
 	}
 	
-	unsigned chk = strtoul(h->checksum, NULL, 8);
+	unsigned chk = htar_octal(h, checksum);
 	if( chk != tar_checksum(h) ){
 		dbg_error("wrong checksum");
 		tar->err = EBADE;
@@ -204,62 +310,78 @@ __private htar_s* htar_get(tar_s* tar){
 	return h;
 }
 
-__private int htar_pax(tar_s* tar, htar_s* h, tarent_s* ent){
-	unsigned size = strtoul(h->size, NULL, 8);
+__private int htar_pax(tar_s* tar, htar_s* h, tarpax_s* pax){
+	const size_t size = htar_octal(h, size);
 	char* kv  = (char*)((uintptr_t)h + sizeof(htar_s));
 	char* ekv = kv + size;
 	while( kv < ekv ){
-		unsigned kvsize = strtoul(kv, &kv, 10);
-		++kv;
-		char* k = kv;
-		char* ek = strchr(k, '=');
+		char* rec = kv;
+		unsigned long kvsize = strtoul(kv, &kv, 10);
+		if( *kv++ != ' ' || !kvsize || rec + kvsize > ekv ){
+			tar->err = EINVAL;
+			dbg_error("wrong pax record");
+			return -1;
+		}
+		char* k  = kv;
+		char* ek = memchr(k, '=', rec + kvsize - k);
 		if( !ek ){
 			tar->err = EINVAL;
-			dbg_error("aspected assign: '%s'", kv);
+			dbg_error("aspected assign: '%.*s'", (int)(rec + kvsize - k), k);
 			return -1;
 		}
-		char* v = ek+1;
-		kv = k + kvsize;
+		char* v  = ek+1;
+		kv = rec + kvsize;
 		char* ev = kv - 1;
+		const size_t klen = ek - k;
 	
-		if( !strncmp(k, "size", 4) ){
-			ent->size = strtoul(v, NULL, 10);
+		if( klen == 4 && !memcmp(k, "size", 4) ){
+			pax->size = strtoul(v, NULL, 10);
+		}
+		else if( klen == 4 && !memcmp(k, "path", 4) ){
+			pax->path.str = v;
+			pax->path.len = ev - v;
 		}
-		else if( !strncmp(k, "path", 4) ){
-			if( ev-v >= PATH_MAX ) die("tar ent unsupported path > %u", PATH_MAX );
-			memcpy(ent->path, v, ev - v);
-			ent->path[ev-v] = 0;
+		else if( klen == 8 && !memcmp(k, "linkpath", 8) ){
+			pax->link.str = v;
+			pax->link.len = ev - v;
 		}
 		else{
-			dbg_warning("todo add this: '%s' = '%.*s'", k, (int)(ev-v), v);
+			dbg_warning("todo add this: '%.*s' = '%.*s'", (int)klen, k, (int)(ev-v), v);
 		}
 	}
 
 	return 0;
 }
 
-__private void htar_next_ent(tar_s* tar, tarent_s* ent){
-	const size_t rawsize = ROUND_UP(ent->size, sizeof(htar_s));
-	tar->loaddr += sizeof(htar_s) + rawsize;
+//global header can be far from entry, copy the little it contains
+__private void tar_global(tar_s* tar, tarpax_s* g){
+	if( g->size ) tar->global.size = g->size;
+	if( g->path.len ){
+		if( g->path.len >= PATH_MAX ) die("tar ent unsupported path > %u", PATH_MAX );
+		memcpy(tar->gpath, g->path.str, g->path.len);
+		tar->global.path.str = tar->gpath;
+		tar->global.path.len = g->path.len;
+	}
 }
 
 __private void htar_next_htar(tar_s* tar, htar_s* h){
-	size_t s = strtoul(h->size, NULL, 8);
+	size_t s = htar_octal(h, size);
 	const size_t rawsize = ROUND_UP(s, sizeof(htar_s));
 	tar->loaddr += sizeof(htar_s) + rawsize;
 }
 
 tarent_s* tar_next(tar_s* tar, tarent_s* ent){
 	htar_s* h;
-	tarent_s pax = {0};
-	memset(ent, 0, sizeof(tarent_s));
+	tarpax_s pax = {0};
 
 	while( (h = htar_get(tar)) ){
 		switch( h->typeflag ){
-			case 'g':
-				if( htar_pax(tar, h, &tar->global) ) goto ONERR;
+			case 'g':{
+				tarpax_s g = {0};
+				if( htar_pax(tar, h, &g) ) goto ONERR;
+				tar_global(tar, &g);
 				htar_next_htar(tar, h);
-			break;
+			}break;
 			
 			case 'x':
 				if( htar_pax(tar, h, &pax) ) goto ONERR;
@@ -267,7 +389,8 @@ tarent_s* tar_next(tar_s* tar, tarent_s* ent){
 			break;
 			
 			case '0' ... '9':
-				ent->type = h->typeflag - '0';
+				ent->header = h;
+				ent->type   = h->typeflag - '0';
 				if( pax.size > 0 ){
 					ent->size = pax.size;
 				}
@@ -275,39 +398,34 @@ tarent_s* tar_next(tar_s* tar, tarent_s* ent){
 					ent->size = tar->global.size;
 				}
 				else{
-					ent->size = strtoul(h->size, NULL, 8);
+					ent->size = htar_octal(h, size);
 				}
 				ent->data = ent->size ? (void*)(tar->loaddr + sizeof(htar_s)) : NULL;
 				
-				if( pax.path[0] ){
-					strcpy(ent->path, pax.path);
-					pax.path[0] = 0;
+				ent->prefix.len = 0;
+				if( pax.path.len ){
+					ent->path = pax.path;
 				}
-				else if( tar->global.path[0] ){
-					strcpy(ent->path, tar->global.path);
+				else if( tar->global.path.len ){
+					ent->path = tar->global.path;
 				}
 				else{
+					ent->path.str = h->name;
+					ent->path.len = strnlen(h->name, sizeof h->name);
 					if( h->prefix[0] ){
-						size_t pl = strnlen(h->prefix, sizeof h->prefix);
-						size_t nl = strnlen(h->name, sizeof h->name);
-						if( pl+nl+1 >= PATH_MAX ) die("tar ent unsupported path > %u", PATH_MAX );
-						memcpy(ent->path, h->prefix, pl);
-						ent->path[pl] = '/';
-						memcpy(&ent->path[pl+1], h->name, nl);
-						ent->path[pl+nl+1] = 0;
-					}
-					else{
-						size_t nl = strnlen(h->name, sizeof h->name);
-						if( nl >= PATH_MAX ) die("tar ent unsupported path > %u", PATH_MAX );
-						memcpy(ent->path, h->name, nl);
-						ent->path[nl] = 0;
+						ent->prefix.str = h->prefix;
+						ent->prefix.len = strnlen(h->prefix, sizeof h->prefix);
 					}
 				}
-				ent->uid  = strtoul(h->uid, NULL, 10);
-				ent->gid  = strtoul(h->gid, NULL, 10);
-				ent->perm = strtol(h->mode, NULL, 8);
-				if( ent->type == TAR_SYMBOLIC_LINK ) ent->data = h->linkname;
-				htar_next_ent(tar, ent);
+				if( pax.link.len ){
+					ent->link = pax.link;
+				}
+				else{
+					ent->link.str = h->linkname;
+					ent->link.len = strnlen(h->linkname, sizeof h->linkname);
+				}
+				if( ent->type == TAR_SYMBOLIC_LINK ) ent->data = (void*)ent->link.str;
+				tar->loaddr += sizeof(htar_s) + ROUND_UP(ent->size, sizeof(htar_s));
 			return ent;
 			
 			default:
@@ -325,28 +443,246 @@ int tar_errno(tar_s* tar){
 	return tar->err;
 }
 
-unsigned tar_count(void* data, tartype_e type){
-	unsigned count = 0;
-	tar_s tmp;
-	tar_mopen(&tmp, data);
-	tarent_s ent;
-	while( tar_next(&tmp, &ent) ){
-		if( ent.type == type ) ++count;
+size_t tarent_path(tarent_s* ent, char* path, size_t size){
+	const size_t len = ent->prefix.len ? ent->prefix.len + 1 + ent->path.len : ent->path.len;
+	if( len >= size ){
+		errno = ENAMETOOLONG;
+		return 0;
 	}
-	return count;
+	char* p = path;
+	if( ent->prefix.len ){
+		memcpy(p, ent->prefix.str, ent->prefix.len);
+		p += ent->prefix.len;
+		*p++ = '/';
+	}
+	memcpy(p, ent->path.str, ent->path.len);
+	path[len] = 0;
+	return len;
 }
 
+uid_t tarent_uid(tarent_s* ent){
+	return htar_octal((htar_s*)ent->header, uid);
+}
 
+gid_t tarent_gid(tarent_s* ent){
+	return htar_octal((htar_s*)ent->header, gid);
+}
 
+unsigned tarent_perm(tarent_s* ent){
+	return htar_octal((htar_s*)ent->header, mode);
+}
 
+unsigned long tarent_mtime(tarent_s* ent){
+	return htar_octal((htar_s*)ent->header, mtime);
+}
 
+#define TARSTREAM_WINDOW (4096*64)
+
+//true when the next entry, with all its pax headers, is complete in buffer
+__private int tar_ready(tar_s* tar){
+	size_t gsize = tar->global.size;
+	size_t psize = 0;
+	uintptr_t p = tar->loaddr;
+	while( p + sizeof(htar_s) <= tar->end ){
+		htar_s* h = (htar_s*)p;
+		if( !memcmp(h, &zerotar, sizeof zerotar) ) return p + sizeof(htar_s) * 2 <= tar->end;
+		size_t size = htar_octal(h, size);
+		const uintptr_t next = p + sizeof(htar_s) + ROUND_UP(size, sizeof(htar_s));
+		if( h->typeflag == 'g' || h->typeflag == 'x' ){
+			if( next > tar->end ) return 0;
+			tarpax_s pax = {0};
+			if( htar_pax(tar, h, &pax) ) return 1;
+			if( pax.size ){
+				if( h->typeflag == 'g' ) gsize = pax.size;
+				else psize = pax.size;
+			}
+		}
+		else{
+			if( psize > 0 ) size = psize;
+			else if( gsize > 0 ) size = gsize;
+			return p + sizeof(htar_s) + ROUND_UP(size, sizeof(htar_s)) <= tar->end;
+		}
+		p = next;
+	}
+	return 0;
+}
 
+tarstream_s* tarstream_ctor(tarstream_s* ts, tarstream_f fn, tarrestart_f restart, void* ctx){
+	ts->format    = DECOMPRESS_UNKNOW;
+	ts->nmagic    = 0;
+	ts->zstd      = NULL;
+	ts->pending   = MANY(char, TARSTREAM_WINDOW);
+	ts->consumed  = 0;
+	ts->total_out = 0;
+	ts->fn        = fn;
+	ts->restart   = restart;
+	ts->ctx       = ctx;
+	ts->end       = 0;
+	ts->eot       = 0;
+	ts->err       = 0;
+	tar_mopen(&ts->tar, ts->pending);
+	return ts;
+}
 
+void tarstream_dtor(void* pts){
+	tarstream_s* ts = pts;
+	switch( ts->format ){
+		case DECOMPRESS_GZIP:
+			ts->gz.next_out = NULL;
+			gzip_dtor(&ts->gz);
+		break;
+		case DECOMPRESS_ZSTD:
+			ZSTD_freeDCtx(ts->zstd);
+		break;
+		default: break;
+	}
+	ts->format = DECOMPRESS_UNKNOW;
+	mem_free(ts->pending);
+}
 
+void tarstream_restart(tarstream_s* ts){
+	tarstream_dtor(ts);
+	tarstream_ctor(ts, ts->fn, ts->restart, ts->ctx);
+	if( ts->restart ) ts->restart(ts->ctx);
+}
 
+__private int tarstream_parse(tarstream_s* ts){
+	tar_s* tar  = &ts->tar;
+	tar->start  = ts->pending;
+	tar->loaddr = (uintptr_t)ts->pending;
+	tar->end    = tar->loaddr + *mem_len(ts->pending);
+	while( !ts->eot && tar_ready(tar) ){
+		tarent_s ent;
+		if( !tar_next(tar, &ent) ){
+			if( tar->err ) return -1;
+			ts->eot = 1;
+			break;
+		}
+		if( ts->fn(ts->ctx, &ent) ){
+			tar->err = ECANCELED;
+			return -1;
+		}
+	}
+	if( ts->eot ){
+		*mem_len(ts->pending) = 0;
+		return 0;
+	}
+	const size_t remain = tar->end - tar->loaddr;
+	if( remain && tar->loaddr != (uintptr_t)ts->pending ) memmove(ts->pending, (void*)tar->loaddr, remain);
+	*mem_len(ts->pending) = remain;
+	return 0;
+}
 
+__private int tarstream_error(tarstream_s* ts, int err){
+	ts->err = err;
+	errno   = err;
+	return -1;
+}
 
+__private int tarstream_gzip(tarstream_s* ts, const void* data, size_t size){
+	if( ts->end ){
+		dbg_warning("data after end of gzip stream");
+		return 0;
+	}
+	ts->gz.next_in  = (Bytef*)data;
+	ts->gz.avail_in = size;
+	do{
+		ts->pending      = mem_upsize(ts->pending, TARSTREAM_WINDOW);
+		const size_t win = mem_available(ts->pending);
+		ts->gz.next_out  = (Bytef*)&ts->pending[*mem_len(ts->pending)];
+		ts->gz.avail_out = win;
+		int ret = inflate(&ts->gz, Z_NO_FLUSH);
+		if( ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR ){
+			dbg_error("decompression failed: %s", ts->gz.msg ? ts->gz.msg : "unknow");
+			return tarstream_error(ts, EIO);
+		}
+		*mem_len(ts->pending) += win - ts->gz.avail_out;
+		ts->total_out         += win - ts->gz.avail_out;
+		if( tarstream_parse(ts) ) return tarstream_error(ts, ts->tar.err);
+		if( ret == Z_STREAM_END ){
+			ts->end = 1;
+			break;
+		}
+		if( ret == Z_BUF_ERROR && ts->gz.avail_out ) break;
+	}while( ts->gz.avail_in || !ts->gz.avail_out );
+	ts->consumed += size - ts->gz.avail_in;
+	return 0;
+}
 
+__private int tarstream_zstd(tarstream_s* ts, const void* data, size_t size){
+	ZSTD_inBuffer in = {
+		.src  = data,
+		.size = size,
+		.pos  = 0
+	};
+	ZSTD_outBuffer out;
+	do{
+		ts->pending = mem_upsize(ts->pending, TARSTREAM_WINDOW);
+		out.dst  = &ts->pending[*mem_len(ts->pending)];
+		out.size = mem_available(ts->pending);
+		out.pos  = 0;
+		size_t const ret = ZSTD_decompressStream(ts->zstd, &out, &in);
+		if( ZSTD_isError(ret) ){
+			dbg_error("decompression failed: %s", ZSTD_getErrorName(ret));
+			return tarstream_error(ts, EIO);
+		}
+		*mem_len(ts->pending) += out.pos;
+		ts->total_out         += out.pos;
+		//0 only when a frame is completed and flushed
+		ts->end = ret == 0;
+		if( tarstream_parse(ts) ) return tarstream_error(ts, ts->tar.err);
+	}while( in.pos < in.size || out.pos == out.size );
+	ts->consumed += in.pos;
+	return 0;
+}
 
+__private int tarstream_decode(tarstream_s* ts, const void* data, size_t size){
+	switch( ts->format ){
+		case DECOMPRESS_GZIP: return tarstream_gzip(ts, data, size);
+		case DECOMPRESS_ZSTD: return tarstream_zstd(ts, data, size);
+		default: break;
+	}
+	dbg_error("unsupported compression format");
+	return tarstream_error(ts, ENOTSUP);
+}
 
+//format is choosen from the first bytes, can arrive in more than one chunk
+int tarstream_feed(tarstream_s* ts, void* data, size_t size){
+	if( ts->err ){
+		errno = ts->err;
+		return -1;
+	}
+	if( ts->nmagic < sizeof ts->magic ){
+		const size_t n = MIN(size, sizeof ts->magic - ts->nmagic);
+		memcpy(&ts->magic[ts->nmagic], data, n);
+		ts->nmagic += n;
+		data = (char*)data + n;
+		size -= n;
+		if( ts->nmagic < sizeof ts->magic ) return 0;
+		ts->format = decompress_sniff(ts->magic, ts->nmagic);
+		switch( ts->format ){
+			case DECOMPRESS_GZIP:
+				gzip_ctor(&ts->gz);
+			break;
+			case DECOMPRESS_ZSTD:
+				if( !(ts->zstd=ZSTD_createDCtx()) ) die("unable to create zstd ctx");
+			break;
+			default: break;
+		}
+		if( tarstream_decode(ts, ts->magic, ts->nmagic) ) return -1;
+	}
+	return size ? tarstream_decode(ts, data, size) : 0;
+}
 
+int tarstream_finish(tarstream_s* ts){
+	if( ts->err ){
+		errno = ts->err;
+		return -1;
+	}
+	if( !ts->end || !ts->eot ){
+		dbg_error("unterminated %s", ts->end ? "tar" : "compressed stream");
+		errno = ENODATA;
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <notstd/core.h>
+#include <notstd/threads.h>
+#include <notstd/rhhash.h>
+
+#include <auror/atom.h>
+
+//robin hood table map name to index of entry, each shard is locked alone, parser threads rarely wait
+typedef struct atomShard{
+	mutex_t      lock;
+	rhhash_s     table;
+	const char** entry;
+	marena_s*    names;
+}atomShard_s;
+
+__private atomShard_s SHARD[ATOM_SHARDS];
+
+//key is only a reference to name stored in shard arena
+__private void shard_init(atomShard_s* s){
+	rhhash_ctor(&s->table, ATOM_TABLE_SIZE, 0, 0, hash_fasthash);
+	s->entry = MANY(const char*, ATOM_TABLE_SIZE / 2);
+	//entry 0 is not used, atom never is 0
+	mem_ipush(&s->entry);
+	s->names = marena_new(ATOM_NAMES_CHUNK);
+}
+
+atom_t atom_intern(const char* name){
+	const size_t len = strlen(name);
+	const uint64_t h = hash_fasthash(name, len);
+	const unsigned shard = h & (ATOM_SHARDS - 1);
+	const uint64_t hash = h >> ATOM_SHARD_BITS;
+	atomShard_s* s = &SHARD[shard];
+	atom_t ret = ATOM_NONE;
+	mlock(&s->lock){
+		if( !s->table.table ) shard_init(s);
+		rhElement_s* e = rhhash_findh(&s->table, hash, name, len);
+		uintptr_t id;
+		if( e ){
+			id = (uintptr_t)e->data;
+		}
+		else{
+			char* str = AMANY(s->names, char, len + 1);
+			memcpy(str, name, len + 1);
+			id = mem_ipush(&s->entry);
+			s->entry[id] = str;
+			rhhash_addh(&s->table, hash, str, len, (void*)id);
+		}
+		ret = (id << ATOM_SHARD_BITS) | shard;
+	}
+	return ret;
+}
+
+atom_t atom_find(const char* name){
+	const size_t len = strlen(name);
+	const uint64_t h = hash_fasthash(name, len);
+	const unsigned shard = h & (ATOM_SHARDS - 1);
+	atomShard_s* s = &SHARD[shard];
+	atom_t ret = ATOM_NONE;
+	mlock(&s->lock){
+		if( s->table.table ){
+			rhElement_s* e = rhhash_findh(&s->table, h >> ATOM_SHARD_BITS, name, len);
+			if( e ) ret = ((uintptr_t)e->data << ATOM_SHARD_BITS) | shard;
+		}
+	}
+	return ret;
+}
+
+const char* atom_name(atom_t atom){
+	atomShard_s* s = &SHARD[atom & (ATOM_SHARDS - 1)];
+	const char* ret = NULL;
+	mlock(&s->lock){
+		const unsigned id = atom >> ATOM_SHARD_BITS;
+		if( s->entry && id && id < *mem_len(s->entry) ) ret = s->entry[id];
+	}
+	return ret;
+}
@@ -19,7 +19,7 @@ void aur_dtor(void* paur){
 	www_dtor(&aur->w);
 }
 
-__private jvalue_s* aur_search_call(aur_s* aur, const char* search, const char* field){
+__private char* aur_search_call(aur_s* aur, const char* search, const char* field){
 	__free char* escsearch = url_escape(search);
 	__free char* method = str_printf("/search/%s?by=%s", escsearch, field);
 	restret_s rr = www_restapi_call(&aur->w, method);
@@ -30,11 +30,8 @@ __private jvalue_s* aur_search_call(aur_s* aur, const char* search, const char*
 	dbg_info("give value");
 	rr.body = mem_nullterm(rr.body);
 	dbg_info("<SEARCH REPLY>%s</SEARCH REPLY>", rr.body);
-	jvalue_s* out = json_decode(rr.body, NULL, NULL);
-	dbg_info("success decode");
-	mem_free(rr.body);
 	mem_free(rr.header);	
-	return out;
+	return rr.body;
 }
 
 /*
@@ -76,26 +73,16 @@ jvalue_s* aur_info_call(aur_s* aur, char** pkg){
 	return out;
 }
 */
-__private void aur_check_error(jvalue_s* jv){
-	jvalue_s* v = jvalue_property_type(jv, JV_STRING, "type");
-	if( v->type == JV_ERR || !strcmp(v->s, "error") ){
-		if(v->type == JV_ERR ) die("rpc aur not respond with type");
-		die("rpc aur error: %s", jvalue_property_type(jv, JV_STRING, "error")->s );
-	}
-}
-
 void aur_search(aur_s* aur, arch_s* arch, const char* name){
-	jvalue_s* jret = aur_search_call(aur, name, "name-desc");
-	if( !jret ) return;
-	aur_check_error(jret);
-	jvalue_s* results = jvalue_property_type(jret, JV_ARRAY, "results");
-	if( results->type != JV_ARRAY ) die("internal error: report this issue,rpc aur no results array in reply but %d", results->type);
-	database_import_json(arch->aur, DESC_FLAG_MAKEPKG, results);
+	char* body = aur_search_call(aur, name, "name-desc");
+	if( !body ) return;
+	char* error = NULL;
+	char* type = database_import_aur(arch->aur, DESC_FLAG_MAKEPKG, body, &error);
+	if( !type ) die("rpc aur not respond with type");
+	if( !strcmp(type, "error") ) die("rpc aur error: %s", error ? error : "unknow");
 	
-	rbtreeit_s it;
-	rbtreeit_ctor(&it, &arch->aur->elements, 0);
-	desc_s* desc;
-	while( (desc=rbtree_iterate_inorder(&it)) ){
+	mforeach(arch->aur->elements, i){
+		desc_s* desc  = arch->aur->elements[i];
 		desc_s* dsync = database_search_bydesc(arch->local, desc);
 		if( dsync ){
 			if( (desc=desc_nonvirtual(desc)) ){
@@ -103,7 +90,6 @@ void aur_search(aur_s* aur, arch_s* arch, const char* name){
 			}
 		}
 	}
-	rbtreeit_dtor(&it);
 }
 
 /*
@@ -46,6 +46,9 @@ option_s OPT[] = {
 	{'n', "--num-outputs" , "max output value"            , OPT_NUM, 0, 0},
 	{'d', "--destdir"     , "destdir for install"         , OPT_PATH | OPT_EXISTS | OPT_DIR, 0, 0},
 	{'c', "--config"      , "config path"                 , OPT_PATH | OPT_EXISTS, 0, 0},
+	{'o', "--owner"       , "search package own file"     , OPT_STR, 0, 0},
+	{'r', "--required-by" , "installed packages require"  , OPT_STR, 0, 0},
+	{'t', "--orphans"     , "dependency not required"     , OPT_NOARG, 0, 0},
 	{'h', "--help"        , "display this"                , OPT_END | OPT_NOARG, 0, 0}
 };
 
@@ -100,9 +103,9 @@ __private void print_desc_basic(desc_s* desc, config_s* conf){
 	putchar(' ');
 	print_desc_installed(desc);
 	putchar('\n');
-	if( desc->desc ){
+	if( desc->info->desc ){
 		putchar('\t');
-		puts(desc->desc);
+		puts(desc->info->desc);
 	}
 }
 
@@ -114,6 +117,49 @@ __private void print_matchs(fzs_s* matchs, const char* name, unsigned max, confi
 		print_desc_basic(matchs[i].ctx, conf);
 	}
 }
+//local directory is name-version-release
+__private void print_owner(database_s* local, const char* root, const char* path){
+	if( !local->files ) die("file index not available");
+	__free char* rel = fileindex_path(root, path);
+	unsigned owner[64];
+	unsigned count = fileindex_owner(local->files, rel, owner, sizeof_vector(owner));
+	if( !count && *rel && rel[strlen(rel)-1] != '/' ){
+		__free char* dir = str_printf("%s/", rel);
+		count = fileindex_owner(local->files, dir, owner, sizeof_vector(owner));
+	}
+	if( !count ){
+		printf("no package owns %s\n", path);
+		return;
+	}
+	for( unsigned i = 0; i < count; ++i ){
+		const char* name = fileindex_pkg_name(local->files, owner[i]);
+		const char* ver = strrchr(name, '-');
+		if( ver ) while( ver > name && *--ver != '-' );
+		if( ver && ver > name ) printf("%s is owned by %.*s %s\n", path, (int)(ver - name), name, ver + 1);
+		else printf("%s is owned by %s\n", path, name);
+	}
+}
+
+__private void print_required_by(database_s* local, const char* name){
+	desc_s* desc = database_search_byname(local, name);
+	if( !desc ) die("package %s is not installed", name);
+	__free desc_s** req = database_required_by(local, desc, MANY(desc_s*, 16));
+	if( !*mem_len(req) ){
+		printf("%s is not required by any package%s\n", name, desc->reason ? ", is orphan" : "");
+		return;
+	}
+	mforeach(req, i){
+		printf("%s is required by %s %s\n", name, req[i]->name, req[i]->version);
+	}
+}
+
+__private void print_orphans(database_s* local){
+	__free desc_s** orphans = database_orphans(local, MANY(desc_s*, 16));
+	mforeach(orphans, i){
+		printf("%s %s\n", orphans[i]->name, orphans[i]->version);
+	}
+}
+
 /*
 __private void print_pkg_deps(pkgInfo_s* pkg, unsigned tab, unsigned w){
 	unsigned cw = tab * 2;
@@ -467,13 +513,13 @@ int main(int argc, char** argv){
 	
 	transaction_begin(conf);
 
-conf->options.parallel = 1;
+	if( !conf->options.parallel ) conf->options.parallel = cpu_count();
 	job_begin(conf->options.parallel);
 	status_s status;
 	status_ctor(&status, conf, conf->options.parallel);
 	
 	status_description(&status, "sync database");
-	database_sync(&arch, conf, &status, 1);
+	database_sync(&arch, conf, &status, 1, opt[O_r].set || opt[O_t].set);
 	if( opt[O_a].set ) conf->options.aur = !conf->options.aur;
 	
 	if( conf->options.aur ){
@@ -483,9 +529,7 @@ conf->options.parallel = 1;
 	if( opt[O_s].set ){
 		status_description(&status, "search in database");
 		fzs_s* matchs = MANY(fzs_s, 128);
-		for( unsigned i = 0; i < *mem_len(conf->repository); ++i ){
-			matchs = database_match_fuzzy(matchs, arch.sync[i], opt[O_s].value->str);	
-		}
+		matchs = database_sync_match_fuzzy(matchs, &arch, opt[O_s].value->str);
 		if( conf->options.aur ){
 			aur_search(&aur, &arch, opt[O_s].value->str);
 			matchs = database_match_fuzzy(matchs, arch.aur, opt[O_s].value->str);
@@ -493,6 +537,16 @@ conf->options.parallel = 1;
 		print_matchs(matchs, opt[O_s].value->str, opt[O_n].value->ui, conf);
 	}
 
+	if( opt[O_o].set ){
+		print_owner(arch.local, root, opt[O_o].value->str);
+	}
+	if( opt[O_r].set ){
+		print_required_by(arch.local, opt[O_r].value->str);
+	}
+	if( opt[O_t].set ){
+		print_orphans(arch.local);
+	}
+
 	package_resolve(&arch);
 
 	status_dtor(&status);
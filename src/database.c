@@ -13,6 +13,8 @@
 #include <auror/status.h>
 
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 typedef struct jobArg{
 	config_s*           conf;
@@ -22,27 +24,83 @@ typedef struct jobArg{
 	delay_t             download;
 }jobArg_s;
 
-__private int desc_tree_cmp(const void* pa, const void* pb){
-	desc_s* a = (void*)pa;
-	desc_s* b = (void*)pb;
+__private int desc_name_cmp(const void* pa, const void* pb){
+	const desc_s* a = *(desc_s**)pa;
+	const desc_s* b = *(desc_s**)pb;
 	return strcmp(a->name, b->name);
 }
 
 database_s* database_ctor(database_s* db, configRepository_s* repo, unsigned flags){
 	db->mem   = NULL;
+	db->arena = marena_new(DATABASE_ARENA_CHUNK);
+	db->atoms = MANY(desc_s*, DATABASE_ATOMS_SIZE);
+	memset(db->atoms, 0, DATABASE_ATOMS_SIZE * sizeof(desc_s*));
+	db->files = NULL;
 	db->repo  = repo;
 	db->flags = flags;
-	rbtree_ctor(&db->elements, desc_tree_cmp);
+	db->unknown = 0;
+	db->elements = MANY(desc_s*, DATABASE_ELEMENTS);
+	db->provides.first = NULL;
+	db->provides.cand  = MANY(desc_s*, DATABASE_ELEMENTS);
+	db->rdepends.first      = NULL;
+	db->rdepends.dependents = NULL;
+	db->frozen.first = NULL;
+	db->frozen.chain = NULL;
 	return db;
 }
 
+//release all memory and index created from database_ctor and insert, database can be reused with database_ctor
+void database_dtor(database_s* db){
+	if( db->flags & DATABASE_FLAG_FROZEN ) rhhash_dtor(&db->frozen.names);
+	mem_free(db->frozen.first);
+	mem_free(db->frozen.chain);
+	mem_free(db->rdepends.first);
+	mem_free(db->rdepends.dependents);
+	mem_free(db->provides.first);
+	mem_free(db->provides.cand);
+	mem_free(db->elements);
+	mem_free(db->files);
+	mem_free(db->atoms);
+	mem_free(db->arena);
+	mem_free(db->mem);
+	memset(db, 0, sizeof(database_s));
+}
+
+desc_s* database_search_byatom(database_s* db, atom_t atom){
+	return atom < *mem_len(db->atoms) ? db->atoms[atom] : NULL;
+}
+
 desc_s* database_search_byname(database_s* db, const char* name){
-	desc_s tmp = {.name = (char*)name};
-	return rbtree_search(&db->elements, &tmp);
+	if( db->flags & DATABASE_FLAG_FROZEN ){
+		rhElement_s* e = rhhash_find(&db->frozen.names, name, strlen(name));
+		return e ? e->data : NULL;
+	}
+	const atom_t atom = atom_find(name);
+	return atom == ATOM_NONE ? NULL : database_search_byatom(db, atom);
 }
 
 desc_s* database_search_bydesc(database_s* db, desc_s* desc){
-	return rbtree_search(&db->elements, desc);
+	return database_search_byatom(db, desc->atom);
+}
+
+//elements are in insert order until database_freeze, ordered copy only for who need it
+desc_s** database_sorted(database_s* db){
+	const unsigned count = *mem_len(db->elements);
+	desc_s** sorted = MANY(desc_s*, count ? count : 1);
+	if( count ) memcpy(sorted, db->elements, count * sizeof(desc_s*));
+	*mem_len(sorted) = count;
+	qsort(sorted, count, sizeof(desc_s*), desc_name_cmp);
+	return sorted;
+}
+
+//unused slots are always zero, upsize zero only the new memory
+__private void database_atom_set(database_s* db, desc_s* desc){
+	if( desc->atom >= *mem_len(db->atoms) ){
+		const unsigned len = *mem_len(db->atoms);
+		db->atoms = mem_upsize_zero(db->atoms, desc->atom + 1 - len);
+		*mem_len(db->atoms) = desc->atom + 1;
+	}
+	db->atoms[desc->atom] = desc;
 }
 /*
 void database_add(database_s* db, desc_s* desc){
@@ -58,31 +116,25 @@ void database_add(database_s* db, desc_s* desc){
 	rbtree_insert(&db->elements, &desc->node);
 }
 */
+//virtual desc not go in name chain, wait database_provides_index
 void database_insert(database_s* db, desc_s* desc){
+	if( db->flags & DATABASE_FLAG_FROZEN ) die("internal error, database %s is frozen", db->repo->name);
+	if( desc->flags & (DESC_FLAG_PROVIDE | DESC_FLAG_REPLACE) ){
+		dbg_info("  %s%s%s", desc->name, desc->flags & DESC_FLAG_PROVIDE ? "->" : "~>", desc->link->name);
+		const unsigned id = mem_ipush(&db->provides.cand);
+		db->provides.cand[id] = desc;
+		return;
+	}
 	desc_s* d = database_search_bydesc(db, desc);
 	if( d ){
-		if( desc->flags & DESC_FLAG_PROVIDE ){
-			dbg_info("  !+%s->%s", desc->name, desc->link->name);
-		}
-		else if( desc->flags & DESC_FLAG_REPLACE ){
-			dbg_info("  !+%s~>%s", desc->name, desc->link->name);
-		}
-		else{
-			dbg_info("  !+%s", desc->name);
-		}
+		dbg_info("  !+%s", desc->name);
 		ld_before(d, desc);
 	}
 	else{
-		if( desc->flags & DESC_FLAG_PROVIDE ){
-			dbg_info("  ?+%s->%s", desc->name, desc->link->name);
-		}
-		else if( desc->flags & DESC_FLAG_REPLACE ){
-			dbg_info("  ?+%s~>%s", desc->name, desc->link->name);
-		}
-		else{
-			dbg_info("  ?+%s", desc->name);
-		}
-		rbtree_insert(&db->elements, &desc->node);
+		dbg_info("  ?+%s", desc->name);
+		const unsigned id = mem_ipush(&db->elements);
+		db->elements[id] = desc;
+		database_atom_set(db, desc);
 	}
 }
 
@@ -108,14 +160,313 @@ void database_insert_replaces(database_s* db, desc_s* desc){
 	}
 }
 
-desc_s* database_sync_find(database_s** db, const char* name){
-	mforeach(db, i){
-		desc_s* ret = database_search_byname(db[i], name);
-		if( ret ) return ret;
+//same name same evr_order is sorted by name of package that provide, always same order
+__private int provide_cmp(const void* pa, const void* pb){
+	const desc_s* a = *(desc_s**)pa;
+	const desc_s* b = *(desc_s**)pb;
+	if( a->atom != b->atom ) return a->atom < b->atom ? -1 : 1;
+	const int cmp = evr_order(&a->evr, &b->evr);
+	return cmp ? cmp : strcmp(a->link->name, b->link->name);
+}
+
+void database_provides_index(database_s* db){
+	desc_s** cand = db->provides.cand;
+	const unsigned count = *mem_len(cand);
+	qsort(cand, count, sizeof(desc_s*), provide_cmp);
+	const unsigned natoms = count ? cand[count-1]->atom + 1 : 0;
+	if( db->provides.first ) mem_free(db->provides.first);
+	uint32_t* first = MANY(uint32_t, natoms + 1);
+	memset(first, 0, (natoms + 1) * sizeof(uint32_t));
+	*mem_len(first) = natoms + 1;
+	for( unsigned i = 0; i < count; ++i ) ++first[cand[i]->atom + 1];
+	for( unsigned a = 0; a < natoms; ++a ) first[a+1] += first[a];
+	db->provides.first = first;
+	dbg_info("%s provides %u", db->repo->name, count);
+}
+
+desc_s** database_provides(database_s* db, atom_t atom, unsigned* count){
+	*count = 0;
+	if( !db->provides.first || atom + 1 >= *mem_len(db->provides.first) ) return NULL;
+	*count = db->provides.first[atom+1] - db->provides.first[atom];
+	return *count ? &db->provides.cand[db->provides.first[atom]] : NULL;
+}
+
+//first element in lo..hi with epoch and version >= of required, or > if upper
+__private unsigned provide_bound(desc_s** cand, unsigned lo, unsigned hi, const evr_s* version, int upper){
+	while( lo < hi ){
+		const unsigned mid = lo + (hi - lo) / 2;
+		const int cmp = evr_cmp_epoch_version(&cand[mid]->evr, version);
+		if( cmp < 0 || (upper && !cmp) ) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+__private desc_s** provide_push(desc_s** out, desc_s** cand, unsigned lo, unsigned hi){
+	if( lo >= hi ) return out;
+	out = mem_upsize(out, hi - lo);
+	memcpy(&out[*mem_len(out)], &cand[lo], (hi - lo) * sizeof(desc_s*));
+	*mem_len(out) += hi - lo;
+	return out;
+}
+
+//same result of desc_accept_version on each virtual, unversioned provide accept any version
+desc_s** database_provides_accept(database_s* db, desc_s** out, atom_t atom, unsigned flags, const evr_s* version){
+	unsigned count;
+	desc_s** cand = database_provides(db, atom, &count);
+	if( !count ) return out;
+	if( !version->seg ) return provide_push(out, cand, 0, count);
+	unsigned any = 0;
+	unsigned hi  = count;
+	while( any < hi ){
+		const unsigned mid = any + (hi - any) / 2;
+		if( cand[mid]->evr.seg ) hi = mid;
+		else any = mid + 1;
+	}
+	out = provide_push(out, cand, 0, any);
+	const unsigned lower = provide_bound(cand, any, count, version, 0);
+	const unsigned upper = provide_bound(cand, lower, count, version, 1);
+	if( flags & DESC_FLAG_V_LESS    ) out = provide_push(out, cand, any, lower);
+	//same epoch and version, release decide only when both have it
+	for( unsigned i = lower; i < upper; ++i ){
+		if( desc_accept_version(cand[i], flags, version) ){
+			const unsigned id = mem_ipush(&out);
+			out[id] = cand[i];
+		}
+	}
+	if( flags & DESC_FLAG_V_GREATER ) out = provide_push(out, cand, upper, count);
+	return out;
+}
+
+//compact once, after this nobody write in database
+void database_freeze(database_s* db){
+	if( db->flags & DATABASE_FLAG_FROZEN ) return;
+	if( !db->provides.first ) database_provides_index(db);
+	const unsigned count = *mem_len(db->elements);
+	qsort(db->elements, count, sizeof(desc_s*), desc_name_cmp);
+	
+	rhhash_ctor(&db->frozen.names, count + count / 4, 0, 0, hash_fasthash);
+	const unsigned natoms = *mem_len(db->atoms);
+	uint32_t* first = MANY(uint32_t, natoms + 1);
+	memset(first, 0, (natoms + 1) * sizeof(uint32_t));
+	*mem_len(first) = natoms + 1;
+	mforeach(db->elements, i){
+		desc_s* head = db->elements[i];
+		rhhash_add(&db->frozen.names, head->name, strlen(head->name), head);
+		ldforeach(head, d){
+			++first[head->atom + 1];
+		}
+	}
+	for( unsigned a = 0; a < natoms; ++a ) first[a+1] += first[a];
+	
+	desc_s** chain = MANY(desc_s*, first[natoms] ? first[natoms] : 1);
+	*mem_len(chain) = first[natoms];
+	mforeach(db->elements, i){
+		unsigned id = first[db->elements[i]->atom];
+		ldforeach(db->elements[i], d){
+			chain[id++] = d;
+		}
+	}
+	db->frozen.first = first;
+	db->frozen.chain = chain;
+	db->flags |= DATABASE_FLAG_FROZEN;
+	dbg_info("%s frozen %u names %u packages", db->repo->name, count, first[natoms]);
+}
+
+//real packages with same name, contiguous
+desc_s** database_candidates(database_s* db, atom_t atom, unsigned* count){
+	if( !(db->flags & DATABASE_FLAG_FROZEN) ) die("internal error, database %s is not frozen", db->repo->name);
+	*count = 0;
+	if( atom + 1 >= *mem_len(db->frozen.first) ) return NULL;
+	*count = db->frozen.first[atom+1] - db->frozen.first[atom];
+	return *count ? &db->frozen.chain[db->frozen.first[atom]] : NULL;
+}
+
+//one edge for each depends of each real package, count and fill like all other index
+void database_rdepends_index(database_s* db){
+	if( db->flags & DATABASE_FLAG_FROZEN ) die("internal error, database %s is frozen, rdepends index need to be built before", db->repo->name);
+	unsigned natoms = 0;
+	mforeach(db->elements, i){
+		ldforeach(db->elements[i], d){
+			if( !d->depends ) continue;
+			mforeach(d->depends, j){
+				if( d->depends[j].atom + 1 > natoms ) natoms = d->depends[j].atom + 1;
+			}
+		}
+	}
+	if( db->rdepends.first ) mem_free(db->rdepends.first);
+	if( db->rdepends.dependents ) mem_free(db->rdepends.dependents);
+	uint32_t* first = MANY(uint32_t, natoms + 1);
+	memset(first, 0, (natoms + 1) * sizeof(uint32_t));
+	*mem_len(first) = natoms + 1;
+	mforeach(db->elements, i){
+		ldforeach(db->elements[i], d){
+			if( !d->depends ) continue;
+			mforeach(d->depends, j){
+				++first[d->depends[j].atom + 1];
+			}
+		}
+	}
+	for( unsigned a = 0; a < natoms; ++a ) first[a+1] += first[a];
+	
+	desc_s** dependents = MANY(desc_s*, first[natoms] ? first[natoms] : 1);
+	*mem_len(dependents) = first[natoms];
+	__free uint32_t* fill = MANY(uint32_t, natoms ? natoms : 1);
+	if( natoms ) memcpy(fill, first, natoms * sizeof(uint32_t));
+	mforeach(db->elements, i){
+		ldforeach(db->elements[i], d){
+			if( !d->depends ) continue;
+			mforeach(d->depends, j){
+				dependents[fill[d->depends[j].atom]++] = d;
+			}
+		}
+	}
+	db->rdepends.first      = first;
+	db->rdepends.dependents = dependents;
+	dbg_info("%s rdepends %u atoms %u edges", db->repo->name, natoms, first[natoms]);
+}
+
+desc_s** database_rdepends(database_s* db, atom_t atom, unsigned* count){
+	if( !db->rdepends.first ) die("internal error, database %s not have rdepends index", db->repo->name);
+	*count = 0;
+	if( atom + 1 >= *mem_len(db->rdepends.first) ) return NULL;
+	*count = db->rdepends.first[atom+1] - db->rdepends.first[atom];
+	return *count ? &db->rdepends.dependents[db->rdepends.first[atom]] : NULL;
+}
+
+//provides of local package are not splitted
+__private atom_t rdepends_provide_atom(const char* provide){
+	const size_t len = strcspn(provide, "<>=");
+	if( !provide[len] ) return atom_find(provide);
+	__free char* name = str_dup(provide, len);
+	return atom_find(name);
+}
+
+__private int rdepends_cmp(const void* pa, const void* pb){
+	const desc_s* a = *(desc_s**)pa;
+	const desc_s* b = *(desc_s**)pb;
+	const int cmp = strcmp(a->name, b->name);
+	if( cmp ) return cmp;
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+__private desc_s** rdepends_push(database_s* db, desc_s** out, atom_t atom){
+	unsigned count;
+	desc_s** dependents = database_rdepends(db, atom, &count);
+	if( !count ) return out;
+	out = mem_upsize(out, count);
+	memcpy(&out[*mem_len(out)], dependents, count * sizeof(desc_s*));
+	*mem_len(out) += count;
+	return out;
+}
+
+//packages of db that require desc by name or by one of his provides, sorted by name
+desc_s** database_required_by(database_s* db, desc_s* desc, desc_s** out){
+	const unsigned start = *mem_len(out);
+	out = rdepends_push(db, out, desc->atom);
+	if( desc->provides ){
+		mforeach(desc->provides, i){
+			const atom_t atom = rdepends_provide_atom(desc->provides[i]);
+			if( atom != ATOM_NONE ) out = rdepends_push(db, out, atom);
+		}
+	}
+	const unsigned count = *mem_len(out) - start;
+	if( count < 2 ) return out;
+	qsort(&out[start], count, sizeof(desc_s*), rdepends_cmp);
+	unsigned w = start + 1;
+	for( unsigned r = start + 1; r < start + count; ++r ){
+		if( out[r] != out[w-1] ) out[w++] = out[r];
+	}
+	*mem_len(out) = w;
+	return out;
+}
+
+//installed as dependency and nobody require it
+desc_s** database_orphans(database_s* db, desc_s** out){
+	__free desc_s** tmp = db->flags & DATABASE_FLAG_FROZEN ? NULL : database_sorted(db);
+	desc_s** sorted = tmp ? tmp : db->elements;
+	__free desc_s** req = MANY(desc_s*, 16);
+	mforeach(sorted, i){
+		ldforeach(sorted[i], d){
+			if( !d->reason ) continue;
+			*mem_len(req) = 0;
+			req = database_required_by(db, d, req);
+			if( !*mem_len(req) ){
+				const unsigned id = mem_ipush(&out);
+				out[id] = d;
+			}
+		}
+	}
+	return out;
+}
+
+//without repo count atoms of database in first[atom+1], with repo store database in repo[first[atom]++]
+__private void sync_index_repo(database_s* db, uint32_t* first, database_s** repo){
+	mforeach(db->elements, j){
+		const atom_t atom = db->elements[j]->atom;
+		if( repo ) repo[first[atom]++] = db;
+		else ++first[atom+1];
+	}
+	const unsigned nvrt = db->provides.first ? *mem_len(db->provides.first) - 1 : 0;
+	for( atom_t atom = 0; atom < nvrt; ++atom ){
+		if( db->provides.first[atom] == db->provides.first[atom+1] || database_search_byatom(db, atom) ) continue;
+		if( repo ) repo[first[atom]++] = db;
+		else ++first[atom+1];
+	}
+}
+
+//after sync repository are immutable, all repository that have a name are merged in one table
+__private void database_sync_index(arch_s* arch){
+	unsigned natoms = 0;
+	mforeach(arch->sync, i){
+		database_s* db = arch->sync[i];
+		database_provides_index(db);
+		if( *mem_len(db->atoms) > natoms ) natoms = *mem_len(db->atoms);
+		if( *mem_len(db->provides.first) - 1 > natoms ) natoms = *mem_len(db->provides.first) - 1;
+	}
+	uint32_t* first = MANY(uint32_t, natoms + 1);
+	memset(first, 0, (natoms + 1) * sizeof(uint32_t));
+	*mem_len(first) = natoms + 1;
+	mforeach(arch->sync, i){
+		sync_index_repo(arch->sync[i], first, NULL);
+	}
+	for( unsigned a = 0; a < natoms; ++a ) first[a+1] += first[a];
+	
+	database_s** repo = MANY(database_s*, first[natoms] ? first[natoms] : 1);
+	*mem_len(repo) = first[natoms];
+	__free uint32_t* fill = MANY(uint32_t, natoms ? natoms : 1);
+	if( natoms ) memcpy(fill, first, natoms * sizeof(uint32_t));
+	mforeach(arch->sync, i){
+		sync_index_repo(arch->sync[i], fill, repo);
+	}
+	arch->index.first = first;
+	arch->index.repo  = repo;
+	dbg_info("sync index %u atoms %u entries", natoms, first[natoms]);
+}
+
+database_s** database_sync_repository(arch_s* arch, atom_t atom, unsigned* count){
+	*count = 0;
+	if( atom + 1 >= *mem_len(arch->index.first) ) return NULL;
+	*count = arch->index.first[atom+1] - arch->index.first[atom];
+	return *count ? &arch->index.repo[arch->index.first[atom]] : NULL;
+}
+
+//first real package in order of repository
+desc_s* database_sync_find_atom(arch_s* arch, atom_t atom){
+	unsigned count;
+	database_s** repo = database_sync_repository(arch, atom, &count);
+	for( unsigned i = 0; i < count; ++i ){
+		desc_s* desc = database_search_byatom(repo[i], atom);
+		if( desc ) return desc;
 	}
 	return NULL;
 }
 
+desc_s* database_sync_find(arch_s* arch, const char* name){
+	const atom_t atom = atom_find(name);
+	return atom == ATOM_NONE ? NULL : database_sync_find_atom(arch, atom);
+}
+
 __private char* database_path(config_s* conf, const char* dbname, int tmp){
 	dbg_info("database path: %s/%s.db%s", conf->options.dbPath, dbname,  (tmp) ? ".download": "");
 	return str_printf("%s/%s.db%s", conf->options.dbPath, dbname, (tmp) ? ".download": "");
@@ -136,22 +487,118 @@ __private delay_t required_sync(config_s* conf){
 	return 0;
 }
 
-__private void* db_load_and_extract(const char* dbpath){
+typedef struct syncStream{
+	jobArg_s*   ja;
+	unsigned    idstatus;
+	size_t      total;
+	tarstream_s ts;
+	snapw_s     sw;
+	snapshot_s* old;
+	unsigned    reused;
+}syncStream_s;
+
+__private void database_multimem_cleanup(void* mdb){
+	char** mb = mdb;
+	mforeach(mb, i){
+		mem_free(mb[i]);
+	}
+}
+
+//block is released with database
+__private void database_own(database_s* db, void* mem){
+	char** blocks = db->mem ? db->mem : MANY(char*, 16, database_multimem_cleanup);
+	unsigned id = mem_ipush(&blocks);
+	blocks[id] = mem;
+	db->mem = blocks;
+}
+
+__private char* database_store(database_s* db, const void* data, size_t size){
+	char** blocks = db->mem;
+	if( !blocks ) blocks = MANY(char*, 16, database_multimem_cleanup);
+	char* blk = *mem_len(blocks) ? blocks[*mem_len(blocks)-1] : NULL;
+	if( !blk || mem_available(blk) < size + 1 ){
+		blk = MANY(char, size + 1 > DATABASE_STORE_BLOCK ? size + 1 : DATABASE_STORE_BLOCK);
+		unsigned id = mem_ipush(&blocks);
+		blocks[id] = blk;
+	}
+	db->mem = blocks;
+	char* ret = &blk[*mem_len(blk)];
+	memcpy(ret, data, size);
+	ret[size] = 0;
+	*mem_len(blk) += size + 1;
+	return ret;
+}
+
+__private void db_sync_insert(syncStream_s* ss, desc_s* desc){
+	database_s* db = ss->ja->db;
+	dbg_info("unpack %s", desc->name);
+	desc_snapshot_store(&ss->sw, desc);
+	database_insert(db, desc);
+	database_insert_provides(db, desc);
+	database_insert_replaces(db, desc);
+}
+
+__private void db_sync_entry_path(tarent_s* ent, char* path){
+	if( !tarent_path(ent, path, PATH_MAX) ) die("tar ent unsupported path > %u", PATH_MAX);
+}
+
+//entry unchanged from previous sync is restored from old snapshot without parsing
+__private desc_s* db_sync_reuse(snapshot_s* old, database_s* db, const char* path, uint32_t crc, size_t size){
+	if( !old ) return NULL;
+	const uint32_t* record = snapshot_entry_find(old, path, crc, size);
+	return record ? desc_snapshot_load(db, old, &record) : NULL;
+}
+
+__private int db_sync_entry(void* ctx, tarent_s* ent){
+	syncStream_s* ss = ctx;
+	if( ent->type != TAR_FILE ) return 0;
+	database_s* db = ss->ja->db;
+	char path[PATH_MAX];
+	db_sync_entry_path(ent, path);
+	const uint32_t crc = crc32(0, ent->data, ent->size);
+	desc_s* desc = db_sync_reuse(ss->old, db, path, crc, ent->size);
+	if( desc ){
+		++ss->reused;
+	}
+	else{
+		char* data = database_store(db, ent->data, ent->size);
+		desc = desc_unpack(db, DESC_FLAG_LAZY, data, ent->size, 0);
+	}
+	snapw_entry(&ss->sw, path, crc, ent->size);
+	db_sync_insert(ss, desc);
+	if( ss->total && !(ss->sw.count % 10) ){
+		const unsigned prog = (100 * ss->ts.total_out) / ss->total;
+		status_refresh(ss->ja->status, ss->idstatus, prog, STATUS_TYPE_WORKING);
+	}
+	return 0;
+}
+
+__private void db_sync_restart(void* ctx){
+	syncStream_s* ss = ctx;
+	dbg_info("restart sync %s", ss->ja->repo->name);
+	database_dtor(ss->ja->db);
+	database_ctor(ss->ja->db, ss->ja->repo, DATABASE_FLAG_MULTIMEM);
+	//reused records are unpacked in place on the private mapping, a second load of same record is not valid
+	ss->old = NULL;
+	snapw_dtor(&ss->sw);
+	snapw_ctor(&ss->sw);
+	desc_snapshot_fields(&ss->sw);
+	ss->reused = 0;
+}
+
+__private int db_load_stream(syncStream_s* ss, const char* dbpath){
 	dbg_info("load %s", dbpath);
-	
-	void* buffers[2] = {
-		MANY(char, BUFLOAD_DEFAULT_SIZE),
-		MANY(char, BUFLOAD_DEFAULT_SIZE)
-	};
-	gzip_t gz;
-	gzip_ctor(&gz);
-	void* ret = NULL;
 	int fd = open(dbpath, O_RDONLY);
 	if( fd == -1 ){
 		dbg_error("unable to open %s: %m", dbpath);
-		goto ATEND;
+		return -1;
 	}
+	ss->total = decompress_file_size(fd);
 	
+	void* buffers[2] = {
+		MANY(char, BUFLOAD_DEFAULT_SIZE),
+		MANY(char, BUFLOAD_DEFAULT_SIZE)
+	};
 	unsigned id = 0;
 	request_t r = r_read(fd, buffers[0], BUFLOAD_DEFAULT_SIZE, -1, 0);
 	r_commit();
@@ -161,89 +608,289 @@ __private void* db_load_and_extract(const char* dbpath){
 		rreturn_s ret = r_await(r);
 		if( ret.ret < 0 ){
 			dbg_error("error on reading %s: %m", dbpath);
-			goto ATEND;
+			break;
 		}
 		size_t nr   = ret.ret;
 		void*  data = buffers[id];
-		if( !nr ) break;
+		if( !nr ){
+			res = tarstream_finish(&ss->ts);
+			break;
+		}
 		id = (id+1) & 1;
 		r = r_read(fd, buffers[id], BUFLOAD_DEFAULT_SIZE, -1, 0);
 		r_commit();
-		res = gzip_decompress(&gz, data, nr);
-	}
-	
-	if( !res ){
-		ret = gz.next_out;
-		gz.next_out = NULL;
+		if( tarstream_feed(&ss->ts, data, nr) ){
+			r_await(r);
+			break;
+		}
 	}
-	else{
-		dbg_error("fail decompression gz %s", dbpath);
+	if( res ){
+		dbg_error("fail decompression %s", dbpath);
 	}
-ATEND:
-	gzip_dtor(&gz);
+	
 	mem_free(buffers[0]);
 	mem_free(buffers[1]);
-	if( fd != -1 ) close(fd);
-	return ret;
+	close(fd);
+	ss->total = 0;
+	return res;
+}
+
+typedef struct syncEntry{
+	tarent_s ent;
+	uint32_t crc;
+}syncEntry_s;
+
+typedef struct syncRange{
+	database_s*  db;
+	snapshot_s*  old;
+	syncEntry_s* ent;
+	desc_s**     desc;
+	unsigned     begin;
+	unsigned     end;
+}syncRange_s;
+
+__private void db_sync_range_job(void* arg){
+	syncRange_s* r = arg;
+	char path[PATH_MAX];
+	for( unsigned i = r->begin; i < r->end; ++i ){
+		tarent_s* ent = &r->ent[i].ent;
+		r->ent[i].crc = crc32(0, ent->data, ent->size);
+		if( r->old ){
+			db_sync_entry_path(ent, path);
+			if( (r->desc[i] = db_sync_reuse(r->old, r->db, path, r->ent[i].crc, ent->size)) ) continue;
+		}
+		r->desc[i] = desc_unpack(r->db, DESC_FLAG_LAZY, ent->data, ent->size, 0);
+	}
+}
+
+//big database are inflated in one buffer and the entries are parsed from all workers, return 1 if need streaming
+__private int db_load_parallel(syncStream_s* ss, const char* dbpath){
+	const unsigned nworker = job_count();
+	if( nworker < 2 ) return 1;
+	int fd = open(dbpath, O_RDONLY);
+	if( fd == -1 ){
+		dbg_error("unable to open %s: %m", dbpath);
+		return -1;
+	}
+	const size_t isize = decompress_file_size(fd);
+	close(fd);
+	if( isize < DATABASE_PARALLEL_SIZE ) return 1;
+	
+	dbg_info("parallel load %s", dbpath);
+	__free char* raw = load_file(dbpath, 0);
+	if( !raw ) return -1;
+	char* dec = decompress_all(raw);
+	if( !dec ){
+		dbg_error("fail decompression %s", dbpath);
+		return -1;
+	}
+	database_s* db = ss->ja->db;
+	database_own(db, dec);
+	
+	__free syncEntry_s* ent = MANY(syncEntry_s, 4096);
+	tar_s tar;
+	tar_mopen(&tar, dec);
+	tarent_s te;
+	while( tar_next(&tar, &te) ){
+		if( te.type != TAR_FILE ) continue;
+		unsigned id = mem_ipush(&ent);
+		ent[id].ent = te;
+	}
+	if( (errno=tar_errno(&tar)) ){
+		dbg_error("unable to unpack database %s", dbpath);
+		return -1;
+	}
+	
+	const unsigned count = *mem_len(ent);
+	__free desc_s** desc = MANY(desc_s*, count ? count : 1);
+	const unsigned nrange = count < nworker * 4 ? 1 : nworker * 4;
+	__free syncRange_s* range = MANY(syncRange_s, nrange);
+	jobGroup_s* group = job_group_new(nrange);
+	for( unsigned i = 0; i < nrange; ++i ){
+		range[i].db    = db;
+		range[i].old   = ss->old;
+		range[i].ent   = ent;
+		range[i].desc  = desc;
+		range[i].begin = (count * i) / nrange;
+		range[i].end   = (count * (i+1)) / nrange;
+		job_group_add(group, db_sync_range_job, &range[i]);
+	}
+	job_group_wait(group);
+	
+	char path[PATH_MAX];
+	for( unsigned i = 0; i < count; ++i ){
+		db_sync_entry_path(&ent[i].ent, path);
+		snapw_entry(&ss->sw, path, ent[i].crc, ent[i].ent.size);
+		db_sync_insert(ss, desc[i]);
+		if( !(i % 10) ) status_refresh(ss->ja->status, ss->idstatus, (100 * (i+1)) / count, STATUS_TYPE_WORKING);
+	}
+	return 0;
+}
+
+__private snapshot_s* db_snapshot_previous(const char* snappath){
+	snapshot_s* snap = snapshot_map(snappath);
+	if( !snap ) return NULL;
+	if( desc_snapshot_check(snap) ){
+		mem_free(snap);
+		return NULL;
+	}
+	return snap;
+}
+
+__private int db_snapshot_load(jobArg_s* ja, unsigned idstatus, snapshot_s* snap, const char* dbpath){
+	if( !snap->hdr->count || snapshot_check_key(snap, dbpath) ) return 0;
+	dbg_info("load snapshot of %s", dbpath);
+	database_own(ja->db, snap);
+	status_refresh(ja->status, idstatus, 0, STATUS_TYPE_WORKING);
+	const uint32_t* record = snap->records;
+	const unsigned total = snap->hdr->count;
+	for( unsigned inc = 0; inc < total; ++inc ){
+		desc_s* desc = desc_snapshot_load(ja->db, snap, &record);
+		database_insert(ja->db, desc);
+		database_insert_provides(ja->db, desc);
+		database_insert_replaces(ja->db, desc);
+		if( !(inc % 10) ){
+			status_refresh(ja->status, idstatus, (100 * (inc+1)) / total, STATUS_TYPE_WORKING);
+		}
+	}
+	dbg_info("sync %s success from snapshot", ja->repo->name);
+	status_completed(ja->status, idstatus);
+	return 1;
+}
+
+//return 1 if server not have a new database and local copy can be used
+__private int db_sync_download(syncStream_s* ss, const char* dbpath, int conditional){
+	jobArg_s* ja = ss->ja;
+	__free char* dbtmppath = database_path(ja->conf, ja->repo->name, 1);
+	if( download_database(dbtmppath, dbpath, ja->status, ss->idstatus, ja->repo, ja->conf, &ss->ts, conditional) == DOWNLOAD_NOT_MODIFIED ){
+		r_unlink(dbtmppath, R_FLAG_NOWAIT);
+		r_commit();
+		return 1;
+	}
+	dbg_info("rename %s -> %s", dbtmppath, dbpath);
+	r_rename(dbtmppath, dbpath, R_FLAG_SEQUENCE | R_FLAG_NOWAIT | R_FLAG_DIE);
+	r_unlink(dbtmppath, R_FLAG_NOWAIT);
+	r_commit();
+	return 0;
 }
 
 __private void db_sync_job(void* arg){
 	jobArg_s* ja = arg;
 	unsigned idstatus = status_new_id(ja->status);
-	ja->db = database_ctor(NEW(database_s), ja->repo, 0);
-	void* decdb = NULL;
+	ja->db = database_ctor(NEW(database_s), ja->repo, DATABASE_FLAG_MULTIMEM);
 	__free char* dbpath = database_path(ja->conf, ja->repo->name, 0);
-	dbg_info("download/load");
-	if( ja->download || !(decdb=db_load_and_extract(dbpath)) ){
-		dbg_info("need download");
-		__free char* dbtmppath = database_path(ja->conf, ja->repo->name, 1);
-		decdb = download_database(dbtmppath, ja->status, idstatus, ja->repo, ja->conf);
-		dbg_info("rename %s -> %s", dbtmppath, dbpath);
-		r_rename(dbtmppath, dbpath, R_FLAG_SEQUENCE | R_FLAG_NOWAIT | R_FLAG_DIE);
-		r_unlink(dbtmppath, R_FLAG_NOWAIT);
-		r_commit();
-	}
-	ja->db->mem = decdb;
-	if( ja->download ){
-		file_time_sec_set(dbpath, ja->download);
-	}
+	__free char* snappath = str_printf("%s.snapshot", dbpath);
+	snapshot_s* old = db_snapshot_previous(snappath);
+	if( old && !ja->download && db_snapshot_load(ja, idstatus, old, dbpath) ) return;
+	if( old ) snapshot_entry_index(old);
 	
-	unsigned total = tar_count(ja->db->mem, TAR_FILE);
+	syncStream_s ss = {
+		.ja       = ja,
+		.idstatus = idstatus,
+		.total    = 0,
+		.old      = old,
+		.reused   = 0
+	};
+	tarstream_ctor(&ss.ts, db_sync_entry, db_sync_restart, &ss);
+	snapw_ctor(&ss.sw);
+	desc_snapshot_fields(&ss.sw);
+	
+	dbg_info("download/load");
 	status_refresh(ja->status, idstatus, 0, STATUS_TYPE_WORKING);
-	tar_s tar;
-	tar_mopen(&tar, ja->db->mem);
-	tarent_s ent;
-	unsigned inc = 0;
-	dbg_info("  total package %u", total);
-	if( total == 0  ) die("internal error, aspected element in database now");
-	while( tar_next(&tar, &ent) ){
-		if( ent.type == TAR_FILE ){
-			desc_s* desc = desc_unpack(ja->db, 0, ent.data, ent.size, 0);
-			dbg_info("unpack %s", desc->name);
-			database_insert(ja->db, desc);
-			database_insert_provides(ja->db, desc);
-			database_insert_replaces(ja->db, desc);
-			++inc;
-			if( !(inc % 10) ){
-				const unsigned prog = (100 * (inc+1)) / total;
-				status_refresh(ja->status, idstatus, prog, STATUS_TYPE_WORKING);
-			}
+	int res = -1;
+	if( ja->download && !db_sync_download(&ss, dbpath, 1) ) res = 0;
+	if( res ){
+		if( ja->download && old && db_snapshot_load(ja, idstatus, old, dbpath) ){
+			dbg_info("%s not modified", ja->repo->name);
+			tarstream_dtor(&ss.ts);
+			snapw_dtor(&ss.sw);
+			file_time_sec_set(dbpath, ja->download);
+			return;
+		}
+		if( (res=db_load_parallel(&ss, dbpath)) > 0 ){
+			res = db_load_stream(&ss, dbpath);
 		}
 	}
-	if( (errno=tar_errno(&tar)) ) die("unable to unpack database");
+	if( res ){
+		dbg_info("need download");
+		tarstream_restart(&ss.ts);
+		db_sync_download(&ss, dbpath, 0);
+	}
+	tarstream_dtor(&ss.ts);
+	dbg_info("  total package %u, unchanged %u", ss.sw.count, ss.reused);
+	//unchanged desc point to old snapshot, new snapshot replace file but not the mapping
+	if( ss.old ) database_own(ja->db, ss.old);
+	else if( old ) mem_free(old);
+	if( ss.sw.count == 0  ) die("internal error, aspected element in database now");
+	if( ja->db->unknown ){
+		dbg_warning("%s skip %u unknown fields", ja->repo->name, ja->db->unknown);
+	}
 	
 	dbg_info("sync %s success", ja->repo->name);
 	status_completed(ja->status, idstatus);
 	r_dispatch(-1);
+	if( ja->download ){
+		file_time_sec_set(dbpath, ja->download);
+	}
+	snapw_store(&ss.sw, snappath, dbpath);
+	snapw_dtor(&ss.sw);
 }
 
-__private void database_multimem_cleanup(void* mdb){
-	char** mb = mdb;
-	mforeach(mb, i){
-		mem_free(mb);
+typedef struct localLoad{
+	char*        name;
+	char*        dirpath;
+	char*        descpath;
+	char*        buf;
+	struct statx stdir;
+	struct statx stdesc;
+	request_t    rdir;
+	request_t    rdesc;
+	request_t    ropen;
+	request_t    rread;
+	int          fd;
+}localLoad_s;
+
+__private void local_open(localLoad_s* ll, const char* localDir){
+	ll->dirpath  = str_printf("%s/%s", localDir, ll->name);
+	ll->descpath = str_printf("%s/desc", ll->dirpath);
+	ll->rdir     = r_statx(ll->dirpath, 0, STATX_MTIME, &ll->stdir, 0);
+	ll->rdesc    = r_statx(ll->descpath, 0, STATX_SIZE, &ll->stdesc, 0);
+	ll->ropen    = r_open(ll->descpath, O_RDONLY, 0, 0);
+}
+
+//desc is read in arena, it is released with database
+__private void local_read(database_s* db, localLoad_s* ll){
+	rreturn_s ret = r_await(ll->ropen);
+	if( ret.ret < 0 ) die("unable to open file: %s, error: %m", ll->descpath);
+	ll->fd = ret.ret;
+	if( r_await(ll->rdesc).ret < 0 ) die("unable to stat file: %s, error: %m", ll->descpath);
+	ll->buf   = AMANY(db->arena, char, ll->stdesc.stx_size + 1);
+	ll->rread = r_read(ll->fd, ll->buf, ll->stdesc.stx_size, 0, 0);
+}
+
+__private desc_s* local_parse(database_s* db, localLoad_s* ll, fileindexDir_s* dir){
+	rreturn_s ret = r_await(ll->rread);
+	if( ret.ret < 0 ) die("unable to read file: %s, error: %m", ll->descpath);
+	size_t size = ret.ret;
+	while( size < ll->stdesc.stx_size ){
+		ssize_t nr = pread(ll->fd, &ll->buf[size], ll->stdesc.stx_size - size, size);
+		if( nr < 0 ) die("unable to read file: %s, error: %m", ll->descpath);
+		if( !nr ) break;
+		size += nr;
 	}
+	ll->buf[size] = 0;
+	r_close(ll->fd, R_FLAG_NOWAIT);
+	dir->name  = ll->name;
+	dir->mtime = 0;
+	if( r_await(ll->rdir).ret >= 0 ){
+		dir->mtime = ll->stdir.stx_mtime.tv_sec * 1000000000ULL + ll->stdir.stx_mtime.tv_nsec;
+	}
+	mem_free(ll->descpath);
+	mem_free(ll->dirpath);
+	return desc_unpack(db, DESC_FLAG_LAZY, ll->buf, size, 1);
 }
 
+//open and stat of next batch are in flight while previous batch is parsed
 __private void db_local_job(void* arg){
 	jobArg_s* ja = arg;
 	unsigned idstatus = status_new_id(ja->status);
@@ -251,37 +898,49 @@ __private void db_local_job(void* arg){
 
 	DIR* d = opendir(ja->conf->options.localDir);
 	if( !d ) die("unable to open path %s :: %m", ja->conf->options.localDir);
-	unsigned total = 0;
+	__free localLoad_s* ll = MANY(localLoad_s, DATABASE_LOCAL_BATCH * 8);
 	struct dirent* ent;
 	while( (ent=readdir(d)) ){
-		if( ent->d_type == DT_DIR && strcmp(ent->d_name, ".") && strcmp(ent->d_name, "..") ) ++total;
+		if( ent->d_type != DT_DIR || !strcmp(ent->d_name, ".") || !strcmp(ent->d_name, "..") ) continue;
+		const unsigned id  = mem_ipush(&ll);
+		const unsigned len = strlen(ent->d_name) + 1;
+		ll[id].name = AMANY(ja->db->arena, char, len);
+		memcpy(ll[id].name, ent->d_name, len);
 	}
-	rewinddir(d);
+	closedir(d);
+	const unsigned total = *mem_len(ll);
 	dbg_info("installed package %u", total);
 
-	char** multibuf = MANY(char*, total, database_multimem_cleanup);
+	__free fileindexDir_s* dirs = MANY(fileindexDir_s, total ? total : 1);
+	*mem_len(dirs) = total;
 	status_refresh(ja->status, idstatus, 0, STATUS_TYPE_WORKING);
-	
-	while( (ent=readdir(d)) ){
-		if( ent->d_type == DT_DIR ){
-			if( !strcmp(ent->d_name, ".") || !strcmp(ent->d_name, "..") ) continue;
-			__free char* descpath = str_printf("%s/%s/desc", ja->conf->options.localDir, ent->d_name);
-			unsigned idbuf = mem_ipush(&multibuf);
-			multibuf[idbuf] = load_file(descpath, 1);
-			database_insert(ja->db,
-				desc_unpack(ja->db, 0, multibuf[idbuf], *mem_len(multibuf[idbuf]), 1)
-			);
-			if( !(idbuf%10) ){
-				const unsigned prog = (100 * (idbuf+1)) / total;
-				status_refresh(ja->status, idstatus, prog, STATUS_TYPE_WORKING);
-			}
+
+	unsigned parsed = 0;
+	for( unsigned b = 0; b < total; b += DATABASE_LOCAL_BATCH ){
+		const unsigned end = b + DATABASE_LOCAL_BATCH < total ? b + DATABASE_LOCAL_BATCH : total;
+		for( unsigned i = b; i < end; ++i ) local_open(&ll[i], ja->conf->options.localDir);
+		r_commit();
+		for( ; parsed < b; ++parsed ){
+			database_insert(ja->db, local_parse(ja->db, &ll[parsed], &dirs[parsed]));
 		}
+		for( unsigned i = b; i < end; ++i ) local_read(ja->db, &ll[i]);
+		r_commit();
+		status_refresh(ja->status, idstatus, (100 * b) / total, STATUS_TYPE_WORKING);
+	}
+	for( ; parsed < total; ++parsed ){
+		database_insert(ja->db, local_parse(ja->db, &ll[parsed], &dirs[parsed]));
+	}
+	r_dispatch(-1);
+
+	__free char* idxpath = str_printf("%s/%s", ja->conf->options.dbPath, DATABASE_FILEINDEX);
+	ja->db->files = fileindex_update(idxpath, ja->conf->options.localDir, dirs);
+	if( ja->db->unknown ){
+		dbg_warning("local skip %u unknown fields", ja->db->unknown);
 	}
-	ja->db->mem  = multibuf;
 	status_completed(ja->status, idstatus);
 }
 
-void database_sync(arch_s* arch, config_s* conf, status_s* status, int forcenodowanload){
+void database_sync(arch_s* arch, config_s* conf, status_s* status, int forcenodowanload, int rdepends){
 	dbg_info("");
 	configRepository_s* aurRepo = NEW(configRepository_s);
 	aurRepo->mirror = NULL;
@@ -340,11 +999,11 @@ void database_sync(arch_s* arch, config_s* conf, status_s* status, int forcenodo
 		*/
 	}
 	
-	rbtreeit_s it;
-	rbtreeit_ctor(&it, &arch->local->elements, 0);
-	desc_s* desc;
-	while( (desc=rbtree_iterate_inorder(&it)) ){
-		desc_s* dsync = database_sync_find(arch->sync, desc->name);
+	database_sync_index(arch);
+	//flags are written before freeze, frozen database is shared from threads
+	mforeach(arch->local->elements, i){
+		desc_s* desc  = arch->local->elements[i];
+		desc_s* dsync = database_sync_find_atom(arch, desc->atom);
 		if( dsync ){
 			if( (dsync = desc_nonvirtual(dsync)) ){
 				dsync->flags |= DESC_FLAG_INSTALLED;
@@ -354,17 +1013,59 @@ void database_sync(arch_s* arch, config_s* conf, status_s* status, int forcenodo
 			desc->flags |= DESC_FLAG_REMOVED;
 		}
 	}
-	rbtreeit_dtor(&it);
+	//required by is asked only to local database, sync repository not pay the index
+	if( rdepends ) database_rdepends_index(arch->local);
+	database_freeze(arch->local);
+	mforeach(arch->sync, i){
+		database_freeze(arch->sync[i]);
+	}
 }
 
-void database_import_json(database_s* db, unsigned flags, jvalue_s* results){
-	mforeach(results->a, i){
-		desc_s* desc = desc_unpack_json(db, flags, &results->a[i]);
-		database_insert(db, desc);
-		database_insert_provides(db, desc);
-		database_insert_replaces(db, desc);
-		dbg_info("add aur: %s", desc->name);
+//body is released with database, reply is {"resultcount":N,"results":[...],"type":"search","version":5}
+char* database_import_aur(database_s* db, unsigned flags, char* body, char** error){
+	database_own(db, body);
+	char* type = NULL;
+	const char* err = NULL;
+	char* parse = json_scan_ws(body);
+	if( *parse != '{' ) die("rpc aur invalid json, aspected object: %.32s", parse);
+	parse = json_scan_ws(parse + 1);
+	while( *parse != '}' ){
+		char* name = json_scan_string(&parse, &err);
+		if( !name ) die("rpc aur invalid json, %s: %.32s", err, parse);
+		parse = json_scan_ws(parse);
+		if( *parse != ':' ) die("rpc aur invalid json, aspected ':': %.32s", parse);
+		parse = json_scan_ws(parse + 1);
+		
+		if( !strcmp(name, "results") && *parse == '[' ){
+			parse = json_scan_ws(parse + 1);
+			while( *parse != ']' ){
+				desc_s* desc = desc_unpack_aur(db, flags, &parse);
+				database_insert(db, desc);
+				database_insert_provides(db, desc);
+				database_insert_replaces(db, desc);
+				dbg_info("add aur: %s", desc->name);
+				parse = json_scan_ws(parse);
+				if( *parse == ',' ) parse = json_scan_ws(parse + 1);
+				else if( *parse != ']' ) die("rpc aur invalid json, aspected ']': %.32s", parse);
+			}
+			++parse;
+		}
+		else if( !strcmp(name, "type") && *parse == '"' ){
+			if( !(type = json_scan_string(&parse, &err)) ) die("rpc aur invalid json, %s: %.32s", err, parse);
+		}
+		else if( !strcmp(name, "error") && *parse == '"' ){
+			if( !(*error = json_scan_string(&parse, &err)) ) die("rpc aur invalid json, %s: %.32s", err, parse);
+		}
+		else if( json_scan_skip(&parse, &err) ){
+			die("rpc aur invalid json, %s: %.32s", err, parse);
+		}
+		
+		parse = json_scan_ws(parse);
+		if( *parse == ',' ) parse = json_scan_ws(parse + 1);
+		else if( *parse != '}' ) die("rpc aur invalid json, aspected '}': %.32s", parse);
 	}
+	database_provides_index(db);
+	return type;
 }
 
 __private fzs_s* match_add(fzs_s* m, void* ctx, const char* name){
@@ -375,33 +1076,63 @@ __private fzs_s* match_add(fzs_s* m, void* ctx, const char* name){
 	return m;
 }
 
+//frozen database is already sorted and can be searched from many threads
 fzs_s* database_match_fuzzy(fzs_s* vf, database_s* db, const char* name){
-	rbtreeit_s it;
-	rbtreeit_ctor(&it, &db->elements, 0);
-	desc_s* desc;
-	while( (desc=rbtree_iterate_inorder(&it)) ){
+	__free desc_s** tmp = db->flags & DATABASE_FLAG_FROZEN ? NULL : database_sorted(db);
+	desc_s** sorted = tmp ? tmp : db->elements;
+	mforeach(sorted, i){
+		desc_s* desc = sorted[i];
 		if( strstr(desc->name, name) ){
-			dbg_info("....");
 			ldforeach(desc, it){
-				dbg_info("%s", it->name);
 				vf = match_add(vf, it, it->name);
 			}
-			dbg_info("-----");
 		}
 		else{
 			ldforeach(desc, it){
-				if( it->flags & (DESC_FLAG_PROVIDE|DESC_FLAG_REPLACE) ){
-					if( it->link->desc && strstr(it->link->desc, name) ){
-						vf = match_add(vf, it, it->name);
-					}
-				}
-				else if( it->desc && strstr(it->desc, name) ){
+				if( it->info->desc && strstr(it->info->desc, name) ){
 					vf = match_add(vf, it, it->name);
 				}
 			}
 		}
 	}
-	rbtreeit_dtor(&it);
+	mforeach(db->provides.cand, i){
+		desc_s* it = db->provides.cand[i];
+		if( strstr(it->name, name) || (it->link->info->desc && strstr(it->link->info->desc, name)) ){
+			vf = match_add(vf, it, it->name);
+		}
+	}
+	return vf;
+}
+
+typedef struct matchJob{
+	database_s* db;
+	const char* name;
+	fzs_s*      match;
+}matchJob_s;
+
+__private void match_job(void* arg){
+	matchJob_s* mj = arg;
+	mj->match = database_match_fuzzy(mj->match, mj->db, mj->name);
+}
+
+//one job for each frozen sync repository, results are appended in order of repository
+fzs_s* database_sync_match_fuzzy(fzs_s* vf, arch_s* arch, const char* name){
+	const unsigned count = *mem_len(arch->sync);
+	__free matchJob_s* mj = MANY(matchJob_s, count ? count : 1);
+	for( unsigned i = 0; i < count; ++i ){
+		mj[i].db    = arch->sync[i];
+		mj[i].name  = name;
+		mj[i].match = MANY(fzs_s, 128);
+		job_new(match_job, &mj[i], 1);
+	}
+	job_wait();
+	for( unsigned i = 0; i < count; ++i ){
+		const unsigned n = *mem_len(mj[i].match);
+		vf = mem_upsize(vf, n);
+		memcpy(&vf[*mem_len(vf)], mj[i].match, n * sizeof(fzs_s));
+		*mem_len(vf) += n;
+		mem_free(mj[i].match);
+	}
 	return vf;
 }
 
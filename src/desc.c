@@ -3,141 +3,114 @@
 #include <notstd/str.h>
 #include <notstd/request.h>
 #include <notstd/list.h>
+#include <notstd/threads.h>
 
 #include <auror/database.h>
 #include <auror/archive.h>
 #include <auror/inutility.h>
 
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 typedef enum {VAR_TYPE_STR, VAR_TYPE_ARR, VAR_TYPE_VER, VAR_TYPE_NUM, VAR_TYPE_DBL} vartype_e;
 
-#define HPERF_DIE() die("unknown field %.*s", (int)(strchrnul(p, '%') - p), p)
-//#define HPERF_DIE() die("unknown field %s", p)
-
-#define HPERF_CASE(CH, STR, TYPE, EL) case CH: do{\
-	ret = strlen(STR);\
-	if( !strncmp(p, STR, ret) ){\
-		*offset = offsetof(desc_s, EL);\
-		*type = TYPE;\
-		return ret;\
-	}\
-	HPERF_DIE();\
-}while(0)
-
-#define HPERF_DEFAULT() default: HPERF_DIE()
-
-__private unsigned desc_hperf(const char* p, unsigned* offset, vartype_e* type){
-	unsigned ret;
-	switch( p[0] ){
-		HPERF_DEFAULT();
-		HPERF_CASE('A', "ARCH"      , VAR_TYPE_STR, arch);
-		HPERF_CASE('F', "FILENAME"  , VAR_TYPE_STR, filename);
-		HPERF_CASE('G', "GROUPS"    , VAR_TYPE_ARR, groups);
-		HPERF_CASE('L', "LICENSE"   , VAR_TYPE_ARR, license);
-		HPERF_CASE('X', "XDATA"     , VAR_TYPE_ARR, xdata);
-		
-		case 'B': switch( p[1] ){
-			HPERF_CASE('A', "BASE"     , VAR_TYPE_STR, base);
-			HPERF_CASE('U', "BUILDDATE", VAR_TYPE_NUM, builddate);
-			HPERF_DEFAULT();
-		}
-		
-		case 'C': switch( p[1] ){
-			HPERF_CASE('H', "CHECKDEPENDS", VAR_TYPE_VER, checkdepends);
-			HPERF_CASE('O', "CONFLICTS"   , VAR_TYPE_VER, conflicts);
-			HPERF_CASE('S', "CSIZE"       , VAR_TYPE_NUM, csize);
-			HPERF_DEFAULT();
-		}
-		
-		case 'D': switch( p[2] ){
-			HPERF_CASE('S', "DESC"   , VAR_TYPE_STR, desc);
-			HPERF_CASE('P', "DEPENDS", VAR_TYPE_VER, depends);
-			HPERF_DEFAULT();
-		}
-		
-		case 'I': switch( p[1] ){
-			HPERF_CASE('S', "ISIZE"      , VAR_TYPE_NUM, isize);
-			HPERF_CASE('N', "INSTALLDATE", VAR_TYPE_NUM, installdate);
-			HPERF_DEFAULT();
-		}
-	
-		case 'M': switch( p[2] ){
-			HPERF_CASE('5', "MD5SUM"     , VAR_TYPE_STR, md5sum);
-			HPERF_CASE('K', "MAKEDEPENDS", VAR_TYPE_VER, makedepends);
-			HPERF_CASE('I', "MAINTAINER" , VAR_TYPE_STR, maintainer);
-			HPERF_DEFAULT();
-		}
-		
-		case 'N': switch( p[1] ){
-			HPERF_CASE('A', "NAME"    , VAR_TYPE_STR, name);
-			HPERF_CASE('U', "NUMVOTES", VAR_TYPE_NUM, numvotes);
-			HPERF_DEFAULT();
-		}
-		
-		case 'O': switch( p[1] ){
-		  	HPERF_CASE('P', "OPTDEPENDS", VAR_TYPE_VER, optdepends);
-			HPERF_CASE('U', "OUTOFDATE" , VAR_TYPE_NUM, outofdate);
-			HPERF_DEFAULT();
-		}
-		
-		case 'P': switch( p[1] ){
-			HPERF_CASE('A', "PACKAGER"  , VAR_TYPE_STR, packager);
-			HPERF_CASE('G', "PGPSIG"    , VAR_TYPE_STR, pgpsig);
-			HPERF_CASE('R', "PROVIDES"  , VAR_TYPE_ARR, provides);
-			HPERF_CASE('O', "POPULARITY", VAR_TYPE_DBL, popularity);
-			HPERF_DEFAULT();
-		}
-		
-		case 'R': switch( p[3] ){
-			HPERF_CASE('L', "REPLACES", VAR_TYPE_ARR, replaces);
-			HPERF_CASE('S', "REASON"  , VAR_TYPE_NUM, reason);
-			HPERF_DEFAULT();
-		}
-		
-		case 'S': switch( p[1] ){
-			HPERF_CASE('H', "SHA256SUM", VAR_TYPE_STR, sha256sum);
-			HPERF_CASE('I', "SIZE"     , VAR_TYPE_NUM, size);
-			HPERF_DEFAULT();
-		}
-		
-		case 'U':
-			if( p[3] == 'P' ){
-				ret = strlen("URLPATH");
-				if( !strncmp(p, "URLPATH", ret) ){
-					*offset = offsetof(desc_s, urlPath);
-					*type = VAR_TYPE_STR;
-					return ret;
-				}
-			}
-			else{
-				ret = strlen("URL");
-				if( !strncmp(p, "URL", ret) ){
-					*offset = offsetof(desc_s, url);
-					*type = VAR_TYPE_STR;
-					return ret;
-				}
-			}
-			HPERF_DIE();
-		
-		case 'V': switch( p[1] ){
-			HPERF_CASE('A', "VALIDATION", VAR_TYPE_STR, validation);
-			HPERF_CASE('E', "VERSION"   , VAR_TYPE_ARR, version);
-			HPERF_DEFAULT();
-		}
-	}
+//key for perfect hash: first, second and last char of name, any field have at least 3 chars
+//if desc is unpacked with DESC_FLAG_LAZY lazy fields stay raw in desc->raw and are decoded from first desc_info
+#define DESC_EAGER 0
+#define DESC_LAZY  1
+
+#define DESC_FIELDS(X)\
+	X(NAME        , 'N', 'A', 'E', DESC_HOT(name)         , VAR_TYPE_STR, DESC_EAGER)\
+	X(VERSION     , 'V', 'E', 'N', DESC_HOT(version)      , VAR_TYPE_STR, DESC_EAGER)\
+	X(BASE        , 'B', 'A', 'E', DESC_COLD(base)        , VAR_TYPE_STR, DESC_EAGER)\
+	X(DESC        , 'D', 'E', 'C', DESC_COLD(desc)        , VAR_TYPE_STR, DESC_EAGER)\
+	X(FILENAME    , 'F', 'I', 'E', DESC_COLD(filename)    , VAR_TYPE_STR, DESC_EAGER)\
+	X(ARCH        , 'A', 'R', 'H', DESC_COLD(arch)        , VAR_TYPE_STR, DESC_EAGER)\
+	X(URL         , 'U', 'R', 'L', DESC_COLD(url)         , VAR_TYPE_STR, DESC_EAGER)\
+	X(URLPATH     , 'U', 'R', 'H', DESC_COLD(urlPath)     , VAR_TYPE_STR, DESC_EAGER)\
+	X(PACKAGER    , 'P', 'A', 'R', DESC_COLD(packager)    , VAR_TYPE_STR, DESC_EAGER)\
+	X(VALIDATION  , 'V', 'A', 'N', DESC_COLD(validation)  , VAR_TYPE_STR, DESC_EAGER)\
+	X(MD5SUM      , 'M', 'D', 'M', DESC_COLD(md5sum)      , VAR_TYPE_STR, DESC_EAGER)\
+	X(SHA256SUM   , 'S', 'H', 'M', DESC_COLD(sha256sum)   , VAR_TYPE_STR, DESC_EAGER)\
+	X(PGPSIG      , 'P', 'G', 'G', DESC_COLD(pgpsig)      , VAR_TYPE_STR, DESC_EAGER)\
+	X(MAINTAINER  , 'M', 'A', 'R', DESC_COLD(maintainer)  , VAR_TYPE_STR, DESC_EAGER)\
+	X(GROUPS      , 'G', 'R', 'S', DESC_COLD(groups)      , VAR_TYPE_ARR, DESC_LAZY )\
+	X(REPLACES    , 'R', 'E', 'S', DESC_HOT(replaces)     , VAR_TYPE_ARR, DESC_EAGER)\
+	X(PROVIDES    , 'P', 'R', 'S', DESC_HOT(provides)     , VAR_TYPE_ARR, DESC_EAGER)\
+	X(XDATA       , 'X', 'D', 'A', DESC_COLD(xdata)       , VAR_TYPE_ARR, DESC_LAZY )\
+	X(LICENSE     , 'L', 'I', 'E', DESC_COLD(license)     , VAR_TYPE_ARR, DESC_LAZY )\
+	X(DEPENDS     , 'D', 'E', 'S', DESC_HOT(depends)      , VAR_TYPE_VER, DESC_EAGER)\
+	X(MAKEDEPENDS , 'M', 'A', 'S', DESC_COLD(makedepends) , VAR_TYPE_VER, DESC_LAZY )\
+	X(CHECKDEPENDS, 'C', 'H', 'S', DESC_COLD(checkdepends), VAR_TYPE_VER, DESC_LAZY )\
+	X(OPTDEPENDS  , 'O', 'P', 'S', DESC_COLD(optdepends)  , VAR_TYPE_VER, DESC_LAZY )\
+	X(CONFLICTS   , 'C', 'O', 'S', DESC_HOT(conflicts)    , VAR_TYPE_VER, DESC_EAGER)\
+	X(BUILDDATE   , 'B', 'U', 'E', DESC_COLD(builddate)   , VAR_TYPE_NUM, DESC_LAZY )\
+	X(INSTALLDATE , 'I', 'N', 'E', DESC_COLD(installdate) , VAR_TYPE_NUM, DESC_LAZY )\
+	X(CSIZE       , 'C', 'S', 'E', DESC_COLD(csize)       , VAR_TYPE_NUM, DESC_LAZY )\
+	X(ISIZE       , 'I', 'S', 'E', DESC_COLD(isize)       , VAR_TYPE_NUM, DESC_LAZY )\
+	X(SIZE        , 'S', 'I', 'E', DESC_COLD(size)        , VAR_TYPE_NUM, DESC_LAZY )\
+	X(REASON      , 'R', 'E', 'N', DESC_HOT(reason)       , VAR_TYPE_NUM, DESC_EAGER)\
+	X(NUMVOTES    , 'N', 'U', 'S', DESC_COLD(numvotes)    , VAR_TYPE_NUM, DESC_LAZY )\
+	X(OUTOFDATE   , 'O', 'U', 'E', DESC_COLD(outofdate)   , VAR_TYPE_NUM, DESC_LAZY )\
+	X(POPULARITY  , 'P', 'O', 'Y', DESC_COLD(popularity)  , VAR_TYPE_DBL, DESC_LAZY )
+
+#define DESC_HASH_SIZE 64
+#define DESC_HASH(FIRST, SECOND, LAST, LEN) ((((unsigned)(FIRST))*5 + ((unsigned)(SECOND))*39 + ((unsigned)(LAST))*3 + (LEN)) & (DESC_HASH_SIZE-1))
+
+typedef struct descField{
+	const char* name;
+	unsigned    len;
+	unsigned    id;
+	int         cold;
+	unsigned    offset;
+	vartype_e   type;
+	int         lazy;
+}descField_s;
+
+#define DESC_FIELD_ID(NAME, FIRST, SECOND, LAST, EL, TYPE, LAZY) DESC_ID_##NAME,
+#define DESC_HOT(EL)  0, offsetof(desc_s, EL)
+#define DESC_COLD(EL) 1, offsetof(descInfo_s, EL)
+#define DESC_FIELD(NAME, FIRST, SECOND, LAST, EL, TYPE, LAZY) { #NAME, sizeof(#NAME)-1, DESC_ID_##NAME, EL, TYPE, LAZY },
+#define DESC_FIELD_HASH(NAME, FIRST, SECOND, LAST, EL, TYPE, LAZY) [DESC_HASH(FIRST, SECOND, LAST, sizeof(#NAME)-1)] = { #NAME, sizeof(#NAME)-1, DESC_ID_##NAME, EL, TYPE, LAZY },
+
+enum { DESC_FIELDS(DESC_FIELD_ID) DESC_ID_COUNT };
+
+//order of fields is used from snapshot
+__private const descField_s DESCFIELD[] = {
+	DESC_FIELDS(DESC_FIELD)
+};
+
+//two fields in same slot is a build error, change the hash
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Woverride-init"
+__private const descField_s DESCHASH[DESC_HASH_SIZE] = {
+	DESC_FIELDS(DESC_FIELD_HASH)
+};
+#pragma GCC diagnostic pop
+
+_Static_assert(sizeof_vector(DESCFIELD) <= DESC_HASH_SIZE, "desc hash table too small");
+_Static_assert(DESC_ID_COUNT <= sizeof(((desc_s*)0)->lazy) * 8, "desc lazy mask too small");
+
+__private void* desc_field_ptr(desc_s* desc, const descField_s* field){
+	return (void*)((uintptr_t)(field->cold ? (void*)desc->info : (void*)desc) + field->offset);
 }
 
-__private char* desc_next(char* p, const char* endparse){
-	while( p < endparse && *p == '\n') ++p;
-	if( p >= endparse ) return NULL;
-	if( *p++ != '%' ) die("aspected field name started with %%\n%s", --p);
-	return p;
+__private const descField_s* desc_field(const char* name, unsigned len){
+	if( len < 3 ) return NULL;
+	const descField_s* f = &DESCHASH[DESC_HASH(name[0], name[1], name[len-1], len)];
+	return f->len == len && !memcmp(f->name, name, len) ? f : NULL;
 }
 
-unsigned desc_parse_and_split_name_version(char* name, char** version){
+//not modify name, len is the size of name without version
+__private unsigned desc_version_find(const char* name, unsigned* len, const char** version){
 	*version = NULL;
-	char* op = strpbrk(name, "<=>");
-	if( !op ) return 0;
-	char* endname = op;
+	const char* op = strpbrk(name, "<=>");
+	if( !op ){
+		*len = strlen(name);
+		return 0;
+	}
+	*len = op - name;
 	unsigned flags = 0;
 	
 	while( *op ){
@@ -147,255 +120,643 @@ unsigned desc_parse_and_split_name_version(char* name, char** version){
 		else break;
 		++op;
 	}
-	*endname = 0;
 	*version = op;
 	return flags;
 }
 
-__private void desc_fill(desc_s* desc, vartype_e const type, unsigned const offset, char** parse, const char* e){
-	char* p = *parse;
-	char* endl = memchr(p, '\n', e-p);
-	iassert( endl > p);
-	if( !endl ) die("aspectd value");
-	void* ptr = (void*)((uintptr_t)desc + offset);
+unsigned desc_parse_and_split_name_version(char* name, char** version){
+	unsigned len;
+	const unsigned flags = desc_version_find(name, &len, (const char**)version);
+	if( *version ) name[len] = 0;
+	return flags;
+}
+
+#define DESC_LINES_STACK 512
+
+//store offset of all new line, return count of lines or max+1 if not have space
+__private unsigned desc_lines(const char* p, unsigned size, uint32_t* nl, unsigned max){
+	unsigned count = 0;
+	unsigned i = 0;
+#if defined(__AVX2__)
+	const __m256i vnl = _mm256_set1_epi8('\n');
+	for( ; i + 32 <= size; i += 32 ){
+		uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)&p[i]), vnl));
+		while( mask ){
+			if( count >= max ) return max+1;
+			nl[count++] = i + FAST_COUNT_0_BIT_RIGHT(mask);
+			mask &= mask - 1;
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	const __m128i vnl16 = _mm_set1_epi8('\n');
+	for( ; i + 16 <= size; i += 16 ){
+		uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)&p[i]), vnl16));
+		while( mask ){
+			if( count >= max ) return max+1;
+			nl[count++] = i + FAST_COUNT_0_BIT_RIGHT(mask);
+			mask &= mask - 1;
+		}
+	}
+#endif
+	for( ; i < size; ++i ){
+		if( p[i] == '\n' ){
+			if( count >= max ) return max+1;
+			nl[count++] = i;
+		}
+	}
+	return count;
+}
+
+//line is [start, nl[i]), value lines end on empty line or on next field
+__private unsigned desc_fill(desc_s* desc, const descField_s* field, char* parse, const uint32_t* nl, unsigned i, unsigned count){
+	void* ptr = desc_field_ptr(desc, field);
+	unsigned start = nl[i-1] + 1;
+	unsigned end = i;
+	while( end < count && start < nl[end] && parse[start] != '%' ){
+		parse[nl[end]] = 0;
+		start = nl[end++] + 1;
+	}
+	const unsigned nvalues = end - i;
+	if( !nvalues ) die("aspectd value");
+	start = nl[i-1] + 1;
 	
-	switch( type ){
-		default: die("internal error, unaspected var type: %d", type);
+	switch( field->type ){
+		default: die("internal error, unaspected var type: %d", field->type);
 		
 		case VAR_TYPE_STR:{
-			char** field = ptr;
-			*field = p;
-			*endl = 0;
-			p = endl+1;
-			if( *p != '\n' && *p != '%' ) die("internal error, desc parse invalid string");
+			if( nvalues != 1 ) die("internal error, desc parse invalid string");
+			*(char**)ptr = &parse[start];
 		}break;
 		
 		case VAR_TYPE_ARR:{
-			int err = -1;
-			char** d = MANY(char*, 4);
-			while( endl && p <= e ){
-				unsigned id = mem_ipush(&d);
-				d[id] = p;
-				*endl = 0;
-				p = endl+1;
-				if( *p == '\n' || *p == '%' ){
-					err = 0;
-					break;
-				}
-				endl = memchr(p, '\n', e-p);
+			char** d = AMANY(desc->db->arena, char*, nvalues);
+			for( unsigned j = i; j < end; ++j ){
+				d[j-i] = &parse[start];
+				start = nl[j] + 1;
 			}
-			if( err ) die("internal error, desc parse invalid array");
+			*mem_len(d) = nvalues;
 			memcpy(ptr, &d, sizeof(char**));
 		}break;
 	
 		case VAR_TYPE_VER:{
-			int err = -1;
-			pkgver_s* d = MANY(pkgver_s, 4);
-			while( endl && p <= e ){
-				*endl = 0;
-				unsigned id = mem_ipush(&d);
-				d[id].name = p;
-				d[id].flags = desc_parse_and_split_name_version(p, &d[id].version);
-				p = endl+1;
-				if( *p == '\n' || *p == '%' ){
-					err = 0;
-					break;
-				}
-				endl = memchr(p, '\n', e-p);
+			pkgver_s* d = AMANY(desc->db->arena, pkgver_s, nvalues);
+			for( unsigned j = i; j < end; ++j ){
+				d[j-i].name  = &parse[start];
+				d[j-i].flags = desc_parse_and_split_name_version(d[j-i].name, &d[j-i].version);
+				d[j-i].atom  = atom_intern(d[j-i].name);
+				evr_arena(&d[j-i].evr, desc->db->arena, d[j-i].version);
+				start = nl[j] + 1;
 			}
-			if( err ) die("internal error, desc parse invalid pkgver");
+			*mem_len(d) = nvalues;
 			memcpy(ptr, &d, sizeof(desc_s*));
 		}break;
 		
 		case VAR_TYPE_NUM:{
+			if( nvalues != 1 ) die("internal error, desc parse invalid number");
 			errno = 0;
 			char* en = NULL;
-			*((unsigned long*)ptr) = strtoul(p, &en, 10);
-			if( errno || !en || en != endl ) die("internal error, desc parse invalid number");
-			p = endl;
+			*((unsigned long*)ptr) = strtoul(&parse[start], &en, 10);
+			if( errno || !en || en != &parse[nl[i]] ) die("internal error, desc parse invalid number");
 		}break;
 	
 		case VAR_TYPE_DBL:{
+			if( nvalues != 1 ) die("internal error, desc parse invalid number");
 			errno = 0;
 			char* en = NULL;
-			*((double*)ptr) = strtod(p, &en);
-			if( errno || !en || en != endl ) die("internal error, desc parse invalid number");
-			p = endl;
+			*((double*)ptr) = strtod(&parse[start], &en);
+			if( errno || !en || en != &parse[nl[i]] ) die("internal error, desc parse invalid number");
 		}break;
 	}
-	*parse = p;
+	return end;
+}
+
+__private unsigned desc_values_end(const char* parse, const uint32_t* nl, unsigned i, unsigned count){
+	while( i < count && nl[i-1] + 1 < nl[i] && parse[nl[i-1] + 1] != '%' ) ++i;
+	return i;
+}
+
+//value lines are only terminated, defer store the first line, values end on empty line or on next field
+__private void desc_defer(desc_s* desc, const descField_s* field, char** defer, char* parse, const uint32_t* nl, unsigned i, unsigned end){
+	defer[field->id] = &parse[nl[i-1] + 1];
+	for( ; i < end; ++i ) parse[nl[i]] = 0;
+	desc->lazy |= 1ULL << field->id;
+}
+
+//raw store only deferred fields in order of id
+__private void desc_defer_commit(desc_s* desc, char** defer){
+	if( !desc->lazy ) return;
+	const unsigned n = __builtin_popcountll(desc->lazy);
+	char** raw = AMANY(desc->db->arena, char*, n);
+	*mem_len(raw) = n;
+	unsigned j = 0;
+	for( uint64_t m = desc->lazy; m; m &= m - 1 ) raw[j++] = defer[__builtin_ctzll(m)];
+	desc->raw = raw;
+}
+
+__private char* lazy_next(char* p){
+	p += strlen(p) + 1;
+	return *p == '\n' || *p == '%' ? NULL : p;
+}
+
+__private unsigned lazy_count(char* p){
+	unsigned n = 0;
+	do{ ++n; }while( (p=lazy_next(p)) );
+	return n;
+}
+
+__private char* lazy_value(desc_s* desc, char** raw, unsigned id){
+	return raw[__builtin_popcountll(desc->lazy & ((1ULL << id) - 1))];
+}
+
+__private mutex_t LAZYLOCK;
+
+__private void desc_materialize(desc_s* desc, char** raw){
+	for( uint64_t m = desc->lazy; m; m &= m - 1 ){
+		const descField_s* field = &DESCFIELD[__builtin_ctzll(m)];
+		void* ptr = desc_field_ptr(desc, field);
+		char* p = lazy_value(desc, raw, field->id);
+		switch( field->type ){
+			default: die("internal error, unaspected lazy type: %d", field->type);
+			
+			case VAR_TYPE_ARR:{
+				const unsigned n = lazy_count(p);
+				char** d = AMANY(desc->db->arena, char*, n);
+				for( unsigned j = 0; j < n; ++j, p = lazy_next(p) ) d[j] = p;
+				*mem_len(d) = n;
+				memcpy(ptr, &d, sizeof(char**));
+			}break;
+			
+			case VAR_TYPE_VER:{
+				const unsigned n = lazy_count(p);
+				pkgver_s* d = AMANY(desc->db->arena, pkgver_s, n);
+				for( unsigned j = 0; j < n; ++j ){
+					char* next = lazy_next(p);
+					d[j].name  = p;
+					d[j].flags = desc_parse_and_split_name_version(p, &d[j].version);
+					d[j].atom  = atom_intern(p);
+					evr_arena(&d[j].evr, desc->db->arena, d[j].version);
+					p = next;
+				}
+				*mem_len(d) = n;
+				memcpy(ptr, &d, sizeof(pkgver_s*));
+			}break;
+			
+			case VAR_TYPE_NUM:{
+				errno = 0;
+				char* en = NULL;
+				*((unsigned long*)ptr) = strtoul(p, &en, 10);
+				if( errno || !en || *en ) die("internal error, desc parse invalid number");
+			}break;
+			
+			case VAR_TYPE_DBL:{
+				errno = 0;
+				char* en = NULL;
+				*((double*)ptr) = strtod(p, &en);
+				if( errno || !en || *en ) die("internal error, desc parse invalid number");
+			}break;
+		}
+	}
+}
+
+//raw is released after typed fields are written, any thread see raw or all decoded fields
+descInfo_s* desc_info(desc_s* desc){
+	if( __atomic_load_n(&desc->raw, __ATOMIC_ACQUIRE) ){
+		mlock(&LAZYLOCK){
+			char** raw = desc->raw;
+			if( raw ){
+				desc_materialize(desc, raw);
+				__atomic_store_n(&desc->raw, NULL, __ATOMIC_RELEASE);
+			}
+		}
+	}
+	return desc->info;
 }
 
 __private desc_s* desc_new(database_s* db, unsigned flags){
-	desc_s* desc = NEW(desc_s);
+	desc_s* desc = ANEW(db->arena, desc_s);
 	mem_zero(desc);
 	ld_ctor(desc);
 	desc->db    = db;
 	desc->flags = flags;
 	desc->var   = -1;
-	rbtNode_ctor(&desc->node, desc);
+	if( !(flags & (DESC_FLAG_PROVIDE | DESC_FLAG_REPLACE)) ){
+		desc->info = ANEW(db->arena, descInfo_s);
+		mem_zero(desc->info);
+	}
 	return desc;
 }
 
 desc_s* desc_unpack(database_s* db, unsigned flags, char* parse, size_t size, int checkmakepkg){
 	desc_s* desc = desc_new(db, flags);
-	const char* e = parse+size;
-	while( (parse=desc_next(parse, e)) ){
-		unsigned offset;
-		vartype_e type;	
-		parse += desc_hperf(parse, &offset, &type);
-		if( *parse++ != '%' ) die("unterminated field, aspected %%");
-		if( *parse++ != '\n') die("aspected new line after %%");
-		desc_fill(desc, type, offset, &parse, e);
+	char* defer[DESC_ID_COUNT];
+	//last line can be without new line, values are terminated in place and byte after buffer is not of desc
+	if( size && parse[size-1] != '\n' ){
+		char* copy = AMANY(db->arena, char, size + 1);
+		memcpy(copy, parse, size);
+		copy[size++] = '\n';
+		parse = copy;
+	}
+	uint32_t stacknl[DESC_LINES_STACK];
+	__free uint32_t* heapnl = NULL;
+	uint32_t* nl = stacknl;
+	unsigned count = desc_lines(parse, size, nl, DESC_LINES_STACK);
+	if( count > DESC_LINES_STACK ){
+		nl = heapnl = MANY(uint32_t, size);
+		count = desc_lines(parse, size, nl, size);
+	}
+	
+	unsigned start = 0;
+	unsigned i = 0;
+	while( i < count ){
+		const unsigned end = nl[i++];
+		if( start == end ){
+			++start;
+			continue;
+		}
+		if( parse[start] != '%' ) die("aspected field name started with %%\n%s", &parse[start]);
+		if( end - start < 3 || parse[end-1] != '%' ) die("unterminated field, aspected %%");
+		const descField_s* field = desc_field(&parse[start+1], end - start - 2);
+		if( !field ){
+			dbg_warning("skip unknown field %.*s", (int)(end - start - 2), &parse[start+1]);
+			__atomic_fetch_add(&db->unknown, 1, __ATOMIC_RELAXED);
+			i = desc_values_end(parse, nl, i, count);
+		}
+		else if( (flags & DESC_FLAG_LAZY) && field->lazy ){
+			//last values of buffer can't be deferred, nothing after the end of values
+			const unsigned vend = desc_values_end(parse, nl, i, count);
+			if( vend == i ) die("aspectd value");
+			if( vend < count ){
+				desc_defer(desc, field, defer, parse, nl, i, vend);
+				i = vend;
+			}
+			else{
+				i = desc_fill(desc, field, parse, nl, i, count);
+			}
+		}
+		else{
+			i = desc_fill(desc, field, parse, nl, i, count);
+		}
+		start = nl[i-1] + 1;
 	}
 	if( !desc->name ) die("desc not have a valid name");
-	if( checkmakepkg && desc->validation && !strcmp(desc->validation, "none") && desc->packager && !strcmp(desc->packager, "Unknown Packager") ){
+	desc_defer_commit(desc, defer);
+	desc->atom = atom_intern(desc->name);
+	evr_arena(&desc->evr, db->arena, desc->version);
+	if( checkmakepkg && desc->info->validation && !strcmp(desc->info->validation, "none") && desc->info->packager && !strcmp(desc->info->packager, "Unknown Packager") ){
 		desc->flags |= DESC_FLAG_MAKEPKG;
 	}
 	return desc;
 }
 
-desc_s* desc_link(database_s* db, desc_s* link, char* name, char* version, unsigned flags){
-	desc_s* vrt  = desc_new(db, flags);
-	vrt->name    = name;
-	vrt->version = version;
-	vrt->link    = link;
-	return vrt;
+void desc_snapshot_fields(snapw_s* sw){
+	for( unsigned i = 0; i < sizeof_vector(DESCFIELD); ++i ){
+		snapw_field(sw, DESCFIELD[i].name);
+	}
 }
 
+//walk all records, entry i point to record i, desc_snapshot_load not need to check bounds
+__private int desc_snapshot_records(snapshot_s* snap){
+	const uint32_t* w   = snap->records;
+	const uint32_t* end = snap->records + snap->words;
+	for( unsigned r = 0; r < snap->hdr->count; ++r ){
+		if( snap->entries[r].record != (uint32_t)(w - snap->records) || w >= end ) return -1;
+		unsigned count = *w++;
+		int name = 0;
+		while( count-->0 ){
+			if( w >= end ) return -1;
+			const unsigned id = *w++;
+			if( id >= sizeof_vector(DESCFIELD) ) return -1;
+			switch( DESCFIELD[id].type ){
+				case VAR_TYPE_STR:
+					if( w >= end || !snapshot_str_valid(snap, *w) ) return -1;
+					if( id == DESC_ID_NAME && *w != SNAPSHOT_NONE ) name = 1;
+					++w;
+				break;
+				
+				case VAR_TYPE_ARR: case VAR_TYPE_VER:{
+					if( w >= end ) return -1;
+					const unsigned step = DESCFIELD[id].type == VAR_TYPE_ARR ? 1 : 3;
+					const uint64_t n = *w++;
+					if( n * step > (uint64_t)(end - w) ) return -1;
+					for( unsigned j = 0; j < n; ++j, w += step ){
+						if( !snapshot_str_valid(snap, w[0]) ) return -1;
+						if( step == 3 && (!snapshot_str_valid(snap, w[1]) || w[0] == SNAPSHOT_NONE) ) return -1;
+					}
+				}break;
+				
+				case VAR_TYPE_NUM: case VAR_TYPE_DBL:
+					if( end - w < 2 ) return -1;
+					w += 2;
+				break;
+			}
+		}
+		if( !name ) return -1;
+	}
+	return 0;
+}
 
-__private void cast_jvaue_tag(desc_s* desc, jvalue_s* jv, unsigned offset, vartype_e type, const char* field){
-	void* ptr = (void*)((uintptr_t)desc + offset);
-	
-	switch( jv->type ){
-		default: case JV_OBJECT: die("internal error, report this issue, json %s is %s but not supported", field, jvalue_type_to_name(jv->type)); break;
+int desc_snapshot_check(snapshot_s* snap){
+	for( unsigned i = 0; i < sizeof_vector(DESCFIELD); ++i ){
+		const char* name = snapshot_field_name(snap, i);
+		if( !name || strcmp(name, DESCFIELD[i].name) ){
+			dbg_warning("snapshot field %u changed", i);
+			return -1;
+		}
+	}
+	if( snapshot_field_name(snap, sizeof_vector(DESCFIELD)) ) return -1;
+	return desc_snapshot_records(snap);
+}
+
+void desc_snapshot_store(snapw_s* sw, desc_s* desc){
+	char** raw = __atomic_load_n(&desc->raw, __ATOMIC_ACQUIRE);
+	const uint64_t lazy = raw ? desc->lazy : 0;
+	const unsigned idcount = *mem_len(sw->words);
+	snapw_word(sw, 0);
+	unsigned count = 0;
+	for( unsigned i = 0; i < sizeof_vector(DESCFIELD); ++i ){
+		void* ptr = desc_field_ptr(desc, &DESCFIELD[i]);
+		switch( DESCFIELD[i].type ){
+			case VAR_TYPE_STR:{
+				char* str = *(char**)ptr;
+				if( !str ) continue;
+				snapw_word(sw, i);
+				snapw_str(sw, str);
+			}break;
 		
-		case JV_STRING:
-			switch( type ){
-				default: die("internal error, report this issue, unaspected var type: %d", type);
-				case VAR_TYPE_DBL: case VAR_TYPE_NUM: die("internal error, report this issue, desc %s unsapected num", field);
-				case VAR_TYPE_STR:{
-					char** set = ptr;
-					*set = mem_borrowed(jv->s);
+			case VAR_TYPE_ARR:{
+				if( lazy & (1ULL << i) ){
+					char* p = lazy_value(desc, raw, i);
+					snapw_word(sw, i);
+					snapw_word(sw, lazy_count(p));
+					do{ snapw_str(sw, p); }while( (p=lazy_next(p)) );
+					break;
 				}
-				break;
-				case VAR_TYPE_ARR:{
-					char** d = MANY(char*, 1);
-					*mem_len(d) = 1;
-					d[0] =  mem_borrowed(jv->s);
-					memcpy(ptr, &d, sizeof(char**));
+				char** arr = *(char***)ptr;
+				if( !arr ) continue;
+				snapw_word(sw, i);
+				snapw_word(sw, *mem_len(arr));
+				mforeach(arr, j){
+					snapw_str(sw, arr[j]);
 				}
-				break;
-				case VAR_TYPE_VER:{
-					pkgver_s* d = MANY(pkgver_s, 1);
-					*mem_len(d) = 1;
-					d[0].name =  mem_borrowed(jv->s);
-					d[0].flags = desc_parse_and_split_name_version(jv->s, &d[0].version);
-					memcpy(ptr, &d, sizeof(pkgver_s*));
+			}break;
+			
+			case VAR_TYPE_VER:{
+				if( lazy & (1ULL << i) ){
+					char* p = lazy_value(desc, raw, i);
+					snapw_word(sw, i);
+					snapw_word(sw, lazy_count(p));
+					do{
+						unsigned len;
+						const char* version;
+						const unsigned flags = desc_version_find(p, &len, &version);
+						snapw_strn(sw, p, len);
+						snapw_str(sw, version);
+						snapw_word(sw, flags);
+					}while( (p=lazy_next(p)) );
+					break;
 				}
-				break;
-			}
-		break;
+				pkgver_s* ver = *(pkgver_s**)ptr;
+				if( !ver ) continue;
+				snapw_word(sw, i);
+				snapw_word(sw, *mem_len(ver));
+				mforeach(ver, j){
+					snapw_str(sw, ver[j].name);
+					snapw_str(sw, ver[j].version);
+					snapw_word(sw, ver[j].flags);
+				}
+			}break;
+			
+			case VAR_TYPE_NUM:{
+				unsigned long num = *(unsigned long*)ptr;
+				if( lazy & (1ULL << i) ) num = strtoul(lazy_value(desc, raw, i), NULL, 10);
+				if( !num ) continue;
+				snapw_word(sw, i);
+				snapw_u64(sw, num);
+			}break;
 			
-		case JV_ARRAY:
-			switch( type ){
-				default: die("internal error, report this issue, unaspected var type: %d", type);
-				case VAR_TYPE_DBL: case VAR_TYPE_NUM: die("internal error, report this issue, desc %s unaspected num", field);
-				case VAR_TYPE_STR:{
-					if( *mem_len(jv->a) != 1 || jv->a[0].type != JV_STRING ) die("internal error, desc %s aspected string but give array", field);
-					char** set = ptr;
-					*set = mem_borrowed(jv->a[0].s);
+			case VAR_TYPE_DBL:{
+				uint64_t dbl;
+				if( lazy & (1ULL << i) ){
+					const double v = strtod(lazy_value(desc, raw, i), NULL);
+					memcpy(&dbl, &v, sizeof dbl);
 				}
-				break;
-				case VAR_TYPE_ARR:{
-					unsigned const count = *mem_len(jv->a);
-					char** d = MANY(char*, count);
-					*mem_len(d) = count;
-					for( unsigned i = 0; i < count; ++i ){
-						if( jv->a[i].type != JV_STRING ) die("internal error, report this issue, desc %s aspected array of string but give %s", field, jvalue_type_to_name(jv->a[i].type));
-						d[0] =  mem_borrowed(jv->a[i].s);
-					}
-					memcpy(ptr, &d, sizeof(char**));
+				else{
+					memcpy(&dbl, ptr, sizeof dbl);
 				}
-				break;
-				case VAR_TYPE_VER:{
-					unsigned const count = *mem_len(jv->a);
-					pkgver_s* d = MANY(pkgver_s, count);
-					*mem_len(d) = count;
-					for( unsigned i = 0; i < count; ++i ){
-						if( jv->a[i].type != JV_STRING ) die("internal error, report this issue, desc %s aspected array of string but give %s", field, jvalue_type_to_name(jv->a[i].type));
-						d[i].name =  mem_borrowed(jv->a[i].s);
-						d[i].flags = desc_parse_and_split_name_version(jv->a[i].s, &d[i].version);
-					}
-					memcpy(ptr, &d, sizeof(pkgver_s*));
+				if( !dbl ) continue;
+				snapw_word(sw, i);
+				snapw_u64(sw, dbl);
+			}break;
+		}
+		++count;
+	}
+	sw->words[idcount] = count;
+	++sw->count;
+}
+
+desc_s* desc_snapshot_load(database_s* db, snapshot_s* snap, const uint32_t** record){
+	const uint32_t* w = *record;
+	desc_s* desc = desc_new(db, 0);
+	unsigned count = *w++;
+	while( count-->0 ){
+		const unsigned id = *w++;
+		if( id >= sizeof_vector(DESCFIELD) ) die("internal error, snapshot corrupted");
+		void* ptr = desc_field_ptr(desc, &DESCFIELD[id]);
+		switch( DESCFIELD[id].type ){
+			case VAR_TYPE_STR:
+				*(char**)ptr = snapshot_str(snap, *w++);
+			break;
+			
+			case VAR_TYPE_ARR:{
+				const unsigned n = *w++;
+				char** d = AMANY(desc->db->arena, char*, n ? n : 1);
+				*mem_len(d) = n;
+				for( unsigned j = 0; j < n; ++j ){
+					d[j] = snapshot_str(snap, *w++);
 				}
-				break;
-			}
-		
-		__fallthrough;
-		case JV_FLOAT:
-		case JV_UNUM:
-		case JV_NUM:{
-			switch( type ){
-				default: die("internal error, report this issue, unaspected var type: %d", type);
-				case VAR_TYPE_STR: die("internal error, report this issue, desc %s aspected num but give string", field);
-				case VAR_TYPE_ARR: die("internal error, report this issue, desc %s unsupported array of num", field);
-				case VAR_TYPE_NUM:
-					*((unsigned long*)ptr) = jv->type == JV_NUM ? jv->u: jv->f;
-				break;
-				case VAR_TYPE_DBL:
-					*((double*)ptr) = jv->type == JV_NUM ? jv->u: jv->f;
-				break;
-			}
+				memcpy(ptr, &d, sizeof(char**));
+			}break;
+			
+			case VAR_TYPE_VER:{
+				const unsigned n = *w++;
+				pkgver_s* d = AMANY(desc->db->arena, pkgver_s, n ? n : 1);
+				*mem_len(d) = n;
+				for( unsigned j = 0; j < n; ++j ){
+					d[j].name    = snapshot_str(snap, *w++);
+					d[j].version = snapshot_str(snap, *w++);
+					d[j].atom    = atom_intern(d[j].name);
+					d[j].flags   = *w++;
+					evr_arena(&d[j].evr, desc->db->arena, d[j].version);
+				}
+				memcpy(ptr, &d, sizeof(pkgver_s*));
+			}break;
+			
+			case VAR_TYPE_NUM:
+				*(unsigned long*)ptr = snapshot_u64(w);
+				w += 2;
+			break;
+			
+			case VAR_TYPE_DBL:{
+				uint64_t dbl = snapshot_u64(w);
+				memcpy(ptr, &dbl, sizeof dbl);
+				w += 2;
+			}break;
 		}
+	}
+	*record = w;
+	if( !desc->name ) die("internal error, snapshot desc not have a valid name");
+	desc->atom = atom_intern(desc->name);
+	evr_arena(&desc->evr, db->arena, desc->version);
+	return desc;
+}
+
+desc_s* desc_link(database_s* db, desc_s* link, char* name, char* version, unsigned flags){
+	desc_s* vrt  = desc_new(db, flags);
+	vrt->name    = name;
+	vrt->version = version;
+	vrt->link    = link;
+	vrt->atom    = atom_intern(name);
+	evr_arena(&vrt->evr, db->arena, version);
+	return vrt;
+}
+
+//aur rpc property and desc field
+__private const char* AURJSON[] = { 
+	"Name", "PackageBase", "Version", "Description", "URL", "Maintainer", "URLPath",
+	"NumVotes", "Popularity", "OutOfDate",
+	"Depends", "MakeDepends", "License", "Provides", "Replaces", "Conflicts"
+};
+__private const char* AURDESC[] = {
+	"NAME", "BASE", "VERSION", "DESC", "URL", "MAINTAINER", "URLPATH", 
+	"NUMVOTES", "POPULARITY", "OUTOFDATE",
+	"DEPENDS", "MAKEDEPENDS", "LICENSE", "PROVIDES", "REPLACES", "CONFLICTS"
+};
+
+__private const descField_s* aur_field(const char* name){
+	for( unsigned j = 0; j < sizeof_vector(AURJSON); ++j ){
+		if( !strcmp(AURJSON[j], name) ) return desc_field(AURDESC[j], strlen(AURDESC[j]));
+	}
+	return NULL;
+}
+
+__private char* aur_string(char** parse){
+	const char* err = NULL;
+	char* str = json_scan_string(parse, &err);
+	if( !str ) die("rpc aur invalid json, %s: %.32s", err, *parse);
+	return str;
+}
+
+__private void aur_store(desc_s* desc, const descField_s* field, char** values){
+	void* ptr = desc_field_ptr(desc, field);
+	const unsigned n = *mem_len(values);
+	switch( field->type ){
+		default: die("internal error, report this issue, desc %s aspected num but give string", field->name);
+		
+		case VAR_TYPE_STR:
+			if( n != 1 ) die("internal error, desc %s aspected string but give array", field->name);
+			*(char**)ptr = values[0];
 		break;
 		
-		case JV_NULL:{
-			switch( type ){
-				default: die("internal error, report this issue, unaspected var type: %d", type);
-				case VAR_TYPE_ARR: die("internal error, report this issue, desc %s unsupported array when jv_null", field);
-				case VAR_TYPE_STR:{
-					char** str = ptr;
-					*str = NEW(char);
-					**str = 0;
-				}
-				break;
-				case VAR_TYPE_NUM:
-					*((unsigned long*)ptr) = 0;
-				break;
-				case VAR_TYPE_DBL:
-					*((double*)ptr) = 0;
-				break;
+		case VAR_TYPE_ARR:{
+			char** d = AMANY(desc->db->arena, char*, n ? n : 1);
+			memcpy(d, values, n * sizeof(char*));
+			*mem_len(d) = n;
+			memcpy(ptr, &d, sizeof(char**));
+		}break;
+		
+		case VAR_TYPE_VER:{
+			pkgver_s* d = AMANY(desc->db->arena, pkgver_s, n ? n : 1);
+			for( unsigned j = 0; j < n; ++j ){
+				d[j].name  = values[j];
+				d[j].flags = desc_parse_and_split_name_version(d[j].name, &d[j].version);
+				d[j].atom  = atom_intern(d[j].name);
+				evr_arena(&d[j].evr, desc->db->arena, d[j].version);
 			}
-		}
+			*mem_len(d) = n;
+			memcpy(ptr, &d, sizeof(pkgver_s*));
+		}break;
+	}
+}
+
+__private void aur_number(desc_s* desc, const descField_s* field, char** parse){
+	void* ptr = desc_field_ptr(desc, field);
+	char* en = NULL;
+	errno = 0;
+	switch( field->type ){
+		default: die("internal error, report this issue, desc %s aspected string but give num", field->name);
+		
+		case VAR_TYPE_NUM:
+			*(unsigned long*)ptr = strtoul(*parse, &en, 10);
+			if( *en == '.' || *en == 'e' || *en == 'E' ) *(unsigned long*)ptr = strtod(*parse, &en);
+		break;
 		
+		case VAR_TYPE_DBL:
+			*(double*)ptr = strtod(*parse, &en);
 		break;
 	}
+	if( errno || en == *parse ) die("rpc aur invalid json, invalid number: %.32s", *parse);
+	*parse = en;
 }
 
-desc_s* desc_unpack_json(database_s* db, unsigned flags, jvalue_s* pkgobj){
-	__private char* fields[] = { 
-		"Name", "PackageBase", "Version", "Description", "URL", "Maintainer", "URLPath",
-		"NumVotes", "Popularity", "OutOfDate",
-		"Depends", "MakeDepends", "License", "Provides", "Replaces", "Conflicts"
-	};
-	__private char* translate[] = {
-		"NAME", "BASE", "VERSION", "DESC", "URL", "MAINTAINER", "URLPATH", 
-		"NUMVOTES", "POPULARITY", "OUTOFDATE",
-		"DEPENDS", "MAKEDEPENDS", "LICENSE", "PROVIDES", "REPLACES", "CONFLICTS"
-	};
-	
+//strings are unescaped inside body and borrowed from desc, body need to be alive as database
+desc_s* desc_unpack_aur(database_s* db, unsigned flags, char** par){
 	desc_s* desc = desc_new(db, flags);
-	for( unsigned j = 0; j < sizeof_vector(fields); ++j ){
-		unsigned offset;
-		vartype_e type;
-		unsigned len = desc_hperf(translate[j], &offset, &type);
-		if( translate[j][len] != 0 ) die("internal cast translate aur error, unterminated field");
-		jvalue_s* prp = jvalue_property(pkgobj, fields[j]);
-		if( prp->type == JV_ERR && j != 0 ) continue;
-		cast_jvaue_tag(desc, prp, offset, type, fields[j]);
+	__free char** values = MANY(char*, 16);
+	const char* err = NULL;
+	char* parse = json_scan_ws(*par);
+	if( *parse != '{' ) die("rpc aur invalid json, aspected object: %.32s", parse);
+	parse = json_scan_ws(parse + 1);
+	
+	while( *parse != '}' ){
+		char* name = aur_string(&parse);
+		parse = json_scan_ws(parse);
+		if( *parse != ':' ) die("rpc aur invalid json, aspected ':': %.32s", parse);
+		parse = json_scan_ws(parse + 1);
+		
+		const descField_s* field = aur_field(name);
+		if( !field ){
+			if( json_scan_skip(&parse, &err) ) die("rpc aur invalid json, %s: %.32s", err, parse);
+		}
+		else if( *parse == '"' ){
+			*mem_len(values) = 0;
+			char* str = aur_string(&parse);
+			values = mem_push(values, &str);
+			aur_store(desc, field, values);
+		}
+		else if( *parse == '[' ){
+			*mem_len(values) = 0;
+			parse = json_scan_ws(parse + 1);
+			while( *parse != ']' ){
+				char* str = aur_string(&parse);
+				values = mem_push(values, &str);
+				parse = json_scan_ws(parse);
+				if( *parse == ',' ) parse = json_scan_ws(parse + 1);
+				else if( *parse != ']' ) die("rpc aur invalid json, aspected ']': %.32s", parse);
+			}
+			++parse;
+			aur_store(desc, field, values);
+		}
+		else if( !strncmp(parse, "null", 4) ){
+			parse += 4;
+			if( field->type == VAR_TYPE_STR ){
+				char** str = desc_field_ptr(desc, field);
+				*str = ANEW(db->arena, char);
+				**str = 0;
+			}
+		}
+		else{
+			aur_number(desc, field, &parse);
+		}
+		
+		parse = json_scan_ws(parse);
+		if( *parse == ',' ) parse = json_scan_ws(parse + 1);
+		else if( *parse != '}' ) die("rpc aur invalid json, aspected '}': %.32s", parse);
 	}
+	*par = parse + 1;
 	if( !desc->name ) die("invalid json package");
+	desc->atom = atom_intern(desc->name);
+	evr_arena(&desc->evr, db->arena, desc->version);
 	return desc;
 }
 
@@ -431,16 +792,16 @@ desc_s* desc_nonvirtual_dump(desc_s* desc){
 	return NULL;
 }
 
-bool desc_accept_version(desc_s* d, unsigned flags, const char* version){
-	if( !d->version ){
+bool desc_accept_version(desc_s* d, unsigned flags, const evr_s* version){
+	if( !d->evr.seg ){
 		dbg_warning("desc %s not have any version", d->name);
 		return true;
 	}
-	if( !version || !*version ){
+	if( !version->seg ){
 		dbg_warning("not setted version for compare desc %s", d->name);
 		return true;
 	}
-	int cmp = vercmp(d->version, version);
+	int cmp = evr_cmp(&d->evr, version);
 	if( cmp < 0 ){
 		return flags & DESC_FLAG_V_LESS ? true : false;
 	}
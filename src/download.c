@@ -7,6 +7,7 @@
 #include <auror/config.h>
 #include <auror/status.h>
 #include <auror/archive.h>
+#include <auror/download.h>
 
 __private char* replace_var(char* dst, const char* src, const char* repo, const char* arch){
 	const char* var;
@@ -82,15 +83,57 @@ int download_lastsync(config_s* conf, delay_t* lastsync){
 }
 
 typedef struct prvArg{
-	int       fd;
-	void*     buffer;
-	void*     decompress;
-	status_s* status;
-	unsigned  idstatus;
-	int       gzret;
-	gzip_t    gz;
+	int          fd;
+	void*        buffer;
+	status_s*    status;
+	unsigned     idstatus;
+	tarstream_s* ts;
+	char*        etag;
+	char*        modified;
 }prvArg_s;
 
+__private void header_value(char** dst, const char* value, size_t len){
+	while( len && (*value == ' ' || *value == '\t') ){
+		++value;
+		--len;
+	}
+	while( len && (value[len-1] == '\r' || value[len-1] == '\n' || value[len-1] == ' ') ) --len;
+	if( *dst ) mem_free(*dst);
+	*dst = len ? str_dup(value, len) : NULL;
+}
+
+__private size_t db_header(void* ptr, size_t size, size_t nmemb, void* userctx){
+	prvArg_s* arg = userctx;
+	size_t const total = size * nmemb;
+	const char* h = ptr;
+	//redirect and retry send more response, validators are only of last
+	if( total > 5 && !strncmp(h, "HTTP/", 5) ){
+		mem_free(arg->etag);
+		mem_free(arg->modified);
+		arg->etag     = NULL;
+		arg->modified = NULL;
+	}
+	else if( total > 5 && !strncasecmp(h, "etag:", 5) ){
+		header_value(&arg->etag, h + 5, total - 5);
+	}
+	else if( total > 14 && !strncasecmp(h, "last-modified:", 14) ){
+		header_value(&arg->modified, h + 14, total - 14);
+	}
+	return total;
+}
+
+//if file can't be rewinded any retry append to old data, abort the mirror
+__private int db_download_restart(void* ctx){
+	prvArg_s* arg = ctx;
+	r_dispatch(-1);
+	if( lseek(arg->fd, 0, SEEK_SET) == (off_t)-1 || ftruncate(arg->fd, 0) ){
+		dbg_error("unable to rewind database file: %m");
+		return -1;
+	}
+	tarstream_restart(arg->ts);
+	return 0;
+}
+
 __private size_t db_save_and_extract(void* ptr, size_t size, size_t nmemb, void* userctx){
 	prvArg_s* arg = userctx;
 	size_t const total = size * nmemb;
@@ -99,57 +142,115 @@ __private size_t db_save_and_extract(void* ptr, size_t size, size_t nmemb, void*
 	memcpy(arg->buffer, ptr, total);
 	r_write(arg->fd, arg->buffer, total, -1, R_FLAG_NOWAIT | R_FLAG_DIE);
 	r_commit();
-	arg->gzret = gzip_decompress(&arg->gz, ptr, total);
+	if( tarstream_feed(arg->ts, ptr, total) ) return 0;
 	return total;
 }
 
+//validators are per mirror, file contains mirror url, etag and last-modified, one for line, empty if not sended
+__private void db_validator_load(const char* cachepath, const char* url, char** etag, char** modified){
+	*etag = NULL;
+	*modified = NULL;
+	__free char* cache = load_file(cachepath, 0);
+	if( !cache ) return;
+	cache = mem_nullterm(cache);
+	char* line[3];
+	char* p = cache;
+	for( unsigned i = 0; i < 3; ++i ){
+		line[i] = p;
+		if( !(p = strchr(p, '\n')) ) return;
+		*p++ = 0;
+	}
+	if( strcmp(line[0], url) ) return;
+	if( *line[1] ) *etag     = str_dup(line[1], 0);
+	if( *line[2] ) *modified = str_dup(line[2], 0);
+}
+
+__private void db_validator_store(const char* cachepath, const char* url, const char* etag, const char* modified){
+	if( !etag && !modified ){
+		unlink(cachepath);
+		return;
+	}
+	FILE* f = fopen(cachepath, "w");
+	if( !f ){
+		dbg_warning("unable to store %s: %m", cachepath);
+		return;
+	}
+	fprintf(f, "%s\n%s\n%s\n", url, etag ? etag : "", modified ? modified : "");
+	fclose(f);
+}
+
 __private void db_download_progress(void* ctx, double perc, double speed, __unused unsigned long eta){
 	prvArg_s* a = ctx;
 	status_speed(a->status, speed);
 	status_refresh(a->status, a->idstatus, perc, STATUS_TYPE_DOWNLOAD);
 }
 
-void* download_database(const char* dbtmpname, status_s* status, unsigned idstatus, configRepository_s* repo, config_s* conf){
+int download_database(const char* dbtmpname, const char* dbpath, status_s* status, unsigned idstatus, configRepository_s* repo, config_s* conf, tarstream_s* ts, int conditional){
 	dbg_info("");
 	prvArg_s a;
 	a.status   = status;
 	a.idstatus = idstatus;
-	a.fd = open(dbtmpname, O_CREAT | O_WRONLY, 0755);
+	a.ts       = ts;
+	a.etag     = NULL;
+	a.modified = NULL;
+	a.fd = open(dbtmpname, O_CREAT | O_TRUNC | O_WRONLY, 0755);
 	if( a.fd == -1 ) die("unable to create temp database %s: %m", dbtmpname);
 	a.buffer = MANY(char*, CURL_MAX_WRITE_SIZE);
+	__free char* cachepath = str_printf("%s.cache", dbpath);
+	if( conditional && access(dbpath, F_OK) ) conditional = 0;
 	
 	mforeach(repo->mirror, i){
-		gzip_ctor(&a.gz);
 		__free char* urlls = str_printf("%s/%s.db", repo->mirror[i], repo->name);
 		dbg_info("try download from mirror %s", urlls);
 		__www www_s w;
-		www_ctor(&w, urlls, DEFAULT_RELAX, DEFAULT_RELAX);
+		mem_free(a.etag);
+		mem_free(a.modified);
+		a.etag     = NULL;
+		a.modified = NULL;
+		//stream can't be replayed, each retry and each mirror restart from begin
+		www_ctor(&w, urlls, DEFAULT_RETRY, DEFAULT_RELAX);
 		www_timeout(&w, conf->options.timeout);
 		www_download_custom(&w, db_save_and_extract, &a);
+		www_header_custom(&w, db_header, &a);
+		www_restart_custom(&w, db_download_restart, &a);
 		www_progress(&w, db_download_progress, &a);
-		if( !www_perform(&w) ){
-			r_dispatch(-1);
+		if( conditional ){
+			__free char* etag = NULL;
+			__free char* modified = NULL;
+			db_validator_load(cachepath, urlls, &etag, &modified);
+			if( etag ){
+				__free char* h = str_printf("If-None-Match: %s", etag);
+				www_header_add(&w, h);
+			}
+			if( modified ){
+				__free char* h = str_printf("If-Modified-Since: %s", modified);
+				www_header_add(&w, h);
+			}
+		}
+		const int ret = www_perform(&w);
+		r_dispatch(-1);
+		if( ret == WWW_NOT_MODIFIED ){
+			dbg_info("database %s not modified", repo->name);
+			close(a.fd);
+			mem_free(a.buffer);
+			mem_free(a.etag);
+			mem_free(a.modified);
+			return DOWNLOAD_NOT_MODIFIED;
+		}
+		if( !ret && !tarstream_finish(ts) ){
 			dbg_info("download completed");
-			void* dec = a.gz.next_out;
-			a.gz.next_out = NULL;
-			if( a.gzret ) die("wrong decompression database %s", repo->name);
-			gzip_dtor(&a.gz);
+			db_validator_store(cachepath, urlls, a.etag, a.modified);
 			close(a.fd);
 			mem_free(a.buffer);
-			return dec;
+			mem_free(a.etag);
+			mem_free(a.modified);
+			return 0;
 		}
-		r_dispatch(-1);
-		lseek(a.fd, 0, SEEK_SET);
-		ftruncate(a.fd, 0);
-		gzip_dtor(&a.gz);
+		if( db_download_restart(&a) ) break;
 	}
 	die("unable to download database %s", repo->name);
 }
 
-
-
-
-
 /*
 typedef struct downctx{
 	config_s*   conf;
@@ -0,0 +1,190 @@
+#include <notstd/core.h>
+
+#include <auror/evr.h>
+
+#define EVR_END   0
+#define EVR_ALPHA 1
+#define EVR_OTHER 2
+
+//not use ctype, version compare not depend from locale
+__private int evr_digit(const char c){
+	return c >= '0' && c <= '9';
+}
+
+__private int evr_alpha(const char c){
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+__private int evr_alnum(const char c){
+	return evr_digit(c) || evr_alpha(c);
+}
+
+unsigned evr_segments(const char* version){
+	//+1 for default epoch
+	unsigned n = 1;
+	const char* s = version;
+	while( *s ){
+		while( *s && !evr_alnum(*s) ) ++s;
+		if( !*s ) break;
+		++n;
+		if( evr_digit(*s) ) while( evr_digit(*s) ) ++s;
+		else while( evr_alpha(*s) ) ++s;
+	}
+	return n;
+}
+
+__private unsigned evr_tokenize(evrSegment_s* seg, const char* s, const char* e, uint8_t* trail){
+	unsigned n = 0;
+	*trail = 0;
+	while( s < e ){
+		const char* sep = s;
+		while( s < e && !evr_alnum(*s) ) ++s;
+		if( s >= e ){
+			*trail = 1;
+			break;
+		}
+		seg[n].sep = s - sep > UINT16_MAX ? UINT16_MAX : s - sep;
+		const char* st = s;
+		if( evr_digit(*s) ){
+			while( s < e && evr_digit(*s) ) ++s;
+			while( st < s && *st == '0' ) ++st;
+			seg[n].num = 1;
+		}
+		else{
+			while( s < e && evr_alpha(*s) ) ++s;
+			seg[n].num = 0;
+		}
+		seg[n].str = st;
+		seg[n].len = s - st;
+		++n;
+	}
+	return n;
+}
+
+//same split of pacman parseEVR, epoch is leading digits followed by ':', release is after last '-'
+void evr_parse(evr_s* evr, evrSegment_s* seg, const char* version){
+	evr->seg = seg;
+	const char* s = version;
+	while( evr_digit(*s) ) ++s;
+	const char* se = strrchr(s, '-');
+	const char* end = se ? se : s + strlen(s);
+
+	if( *s == ':' && s > version ){
+		evr->count[EVR_EPOCH] = evr_tokenize(seg, version, s, &evr->trail[EVR_EPOCH]);
+	}
+	else{
+		seg[0].str = "";
+		seg[0].len = 0;
+		seg[0].sep = 0;
+		seg[0].num = 1;
+		evr->count[EVR_EPOCH] = 1;
+		evr->trail[EVR_EPOCH] = 0;
+	}
+	if( *s == ':' ) version = s + 1;
+	seg += evr->count[EVR_EPOCH];
+
+	evr->count[EVR_VERSION] = evr_tokenize(seg, version, end, &evr->trail[EVR_VERSION]);
+	seg += evr->count[EVR_VERSION];
+
+	evr->release = se ? 1 : 0;
+	evr->count[EVR_RELEASE] = 0;
+	evr->trail[EVR_RELEASE] = 0;
+	if( se ) evr->count[EVR_RELEASE] = evr_tokenize(seg, se + 1, se + 1 + strlen(se + 1), &evr->trail[EVR_RELEASE]);
+}
+
+evr_s* evr_arena(evr_s* evr, marena_s* arena, const char* version){
+	if( !version ){
+		memset(evr, 0, sizeof *evr);
+		return evr;
+	}
+	evr_parse(evr, AMANY(arena, evrSegment_s, evr_segments(version)), version);
+	return evr;
+}
+
+__private int evr_seg_cmp(const evrSegment_s* a, const evrSegment_s* b){
+	if( a->sep != b->sep ) return a->sep < b->sep ? -1 : 1;
+	if( a->num != b->num ) return a->num ? 1 : -1;
+	if( a->num && a->len != b->len ) return a->len < b->len ? -1 : 1;
+	const int r = memcmp(a->str, b->str, a->len < b->len ? a->len : b->len);
+	if( r ) return r < 0 ? -1 : 1;
+	if( a->len != b->len ) return a->len < b->len ? -1 : 1;
+	return 0;
+}
+
+//char where rpmvercmp stop, when only one string remain it not skip separators
+__private int evr_stop(const evrSegment_s* seg, unsigned count, unsigned trail, unsigned k, int skip){
+	if( k < count ){
+		if( !skip && seg[k].sep ) return EVR_OTHER;
+		return seg[k].num ? EVR_OTHER : EVR_ALPHA;
+	}
+	return !skip && trail ? EVR_OTHER : EVR_END;
+}
+
+//token version of rpmvercmp
+__private int evr_part_cmp(const evr_s* a, const evr_s* b, unsigned part){
+	const evrSegment_s* sa = a->seg;
+	const evrSegment_s* sb = b->seg;
+	for( unsigned i = 0; i < part; ++i ){
+		sa += a->count[i];
+		sb += b->count[i];
+	}
+	const unsigned na = a->count[part];
+	const unsigned nb = b->count[part];
+	unsigned k = 0;
+	for( ; k < na && k < nb; ++k ){
+		const int r = evr_seg_cmp(&sa[k], &sb[k]);
+		if( r ) return r;
+	}
+	const int skip = (k < na || a->trail[part]) && (k < nb || b->trail[part]);
+	const int ca = evr_stop(sa, na, a->trail[part], k, skip);
+	const int cb = evr_stop(sb, nb, b->trail[part], k, skip);
+	if( ca == EVR_END && cb == EVR_END ) return 0;
+	if( (ca == EVR_END && cb != EVR_ALPHA) || ca == EVR_ALPHA ) return -1;
+	return 1;
+}
+
+//same result of alpm_pkg_vercmp
+int evr_cmp(const evr_s* a, const evr_s* b){
+	int ret = evr_cmp_epoch_version(a, b);
+	if( !ret && a->seg && b->seg && a->release && b->release ) ret = evr_part_cmp(a, b, EVR_RELEASE);
+	return ret;
+}
+
+//release is not compared
+int evr_cmp_epoch_version(const evr_s* a, const evr_s* b){
+	if( !a->seg && !b->seg ) return 0;
+	if( !a->seg ) return -1;
+	if( !b->seg ) return 1;
+	const int ret = evr_part_cmp(a, b, EVR_EPOCH);
+	return ret ? ret : evr_part_cmp(a, b, EVR_VERSION);
+}
+
+//evr_cmp is 0 when only one have release, it can't sort, without release is before any release
+int evr_order(const evr_s* a, const evr_s* b){
+	const int ret = evr_cmp_epoch_version(a, b);
+	if( ret || !a->seg || !b->seg ) return ret;
+	if( a->release != b->release ) return a->release ? 1 : -1;
+	return a->release ? evr_part_cmp(a, b, EVR_RELEASE) : 0;
+}
+
+int evr_vercmp(const char* a, const char* b){
+	if( !a && !b ) return 0;
+	if( !a ) return -1;
+	if( !b ) return 1;
+	if( !strcmp(a, b) ) return 0;
+
+	evrSegment_s stack[EVR_STACK_SEGMENTS * 2];
+	__free evrSegment_s* heap = NULL;
+	const unsigned na = evr_segments(a);
+	const unsigned nb = evr_segments(b);
+	evrSegment_s* seg = stack;
+	if( na + nb > sizeof_vector(stack) ){
+		heap = MANY(evrSegment_s, na + nb);
+		seg = heap;
+	}
+	evr_s ea;
+	evr_s eb;
+	evr_parse(&ea, seg, a);
+	evr_parse(&eb, seg + na, b);
+	return evr_cmp(&ea, &eb);
+}
@@ -0,0 +1,483 @@
+#include <notstd/core.h>
+#include <notstd/str.h>
+
+#include <auror/fileindex.h>
+#include <auror/inutility.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#define FILEINDEX_ENTRY_SIZE (4096*16)
+#define FILEINDEX_DATA_SIZE  (4096*256)
+
+typedef struct fileindexEntry{
+	const char* path;
+	uint32_t    len;
+	uint32_t    pkg;
+}fileindexEntry_s;
+
+typedef struct fileindexIt{
+	const uint8_t* p;
+	const uint8_t* end;
+	uint32_t       npkg;
+	uint32_t       len;
+	uint32_t       pkg;
+	char           path[FILEINDEX_PATH_MAX];
+}fileindexIt_s;
+
+__private void fileindex_cleanup(void* pfi){
+	fileindex_s* fi = pfi;
+	if( !fi->map ) return;
+	if( fi->mapped ) munmap(fi->map, fi->size);
+	else mem_free(fi->map);
+}
+
+//sections are in write order and inside of image, offsets of packages and blocks are checked once here
+__private int fileindex_layout(fileindex_s* fi){
+	const fileindexHeader_s* h = fi->hdr;
+	if( h->nblock != (h->count + FILEINDEX_BLOCK - 1) / FILEINDEX_BLOCK ) return -1;
+	if( h->pkgs != sizeof(fileindexHeader_s) ) return -1;
+	if( h->blocks != h->pkgs + (uint64_t)h->npkg * sizeof(fileindexPkg_s) ) return -1;
+	if( h->data != h->blocks + (uint64_t)h->nblock * sizeof(uint32_t) ) return -1;
+	if( h->names < h->data || h->names > h->size ) return -1;
+	if( h->npkg && (h->names == h->size || ((char*)fi->map)[h->size - 1]) ) return -1;
+	fi->pkgs   = (fileindexPkg_s*)((uintptr_t)fi->map + h->pkgs);
+	fi->blocks = (uint32_t*)((uintptr_t)fi->map + h->blocks);
+	fi->data   = (uint8_t*)((uintptr_t)fi->map + h->data);
+	fi->names  = (char*)((uintptr_t)fi->map + h->names);
+	const uint64_t namesize = h->size - h->names;
+	for( unsigned i = 0; i < h->npkg; ++i ){
+		if( fi->pkgs[i].name >= namesize ) return -1;
+	}
+	const uint64_t datasize = h->names - h->data;
+	for( unsigned i = 0; i < h->nblock; ++i ){
+		if( fi->blocks[i] >= datasize || (i && fi->blocks[i] <= fi->blocks[i-1]) ) return -1;
+	}
+	return 0;
+}
+
+__private fileindex_s* fileindex_image(void* map, size_t size, int mapped){
+	fileindex_s* fi = NEW(fileindex_s, fileindex_cleanup);
+	fi->map    = map;
+	fi->size   = size;
+	fi->mapped = mapped;
+	fi->hdr    = map;
+	if( size < sizeof(fileindexHeader_s) || memcmp(fi->hdr->magic, FILEINDEX_MAGIC, sizeof FILEINDEX_MAGIC) || fi->hdr->version != FILEINDEX_VERSION || fi->hdr->size != size ){
+		dbg_warning("file index wrong magic, version or size");
+		mem_free(fi);
+		return NULL;
+	}
+	if( fileindex_layout(fi) ){
+		dbg_warning("file index sections out of image");
+		mem_free(fi);
+		return NULL;
+	}
+	return fi;
+}
+
+fileindex_s* fileindex_open(const char* path){
+	int fd = open(path, O_RDONLY);
+	if( fd == -1 ){
+		dbg_info("file index %s not exists", path);
+		return NULL;
+	}
+	struct stat st;
+	if( fstat(fd, &st) || (size_t)st.st_size < sizeof(fileindexHeader_s) ){
+		dbg_warning("invalid file index %s", path);
+		close(fd);
+		return NULL;
+	}
+	void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if( map == MAP_FAILED ){
+		dbg_error("unable to map %s: %m", path);
+		return NULL;
+	}
+	return fileindex_image(map, st.st_size, 1);
+}
+
+const char* fileindex_pkg_name(fileindex_s* fi, unsigned id){
+	return &fi->names[fi->pkgs[id].name];
+}
+
+__private uint8_t* data_varint(uint8_t* data, uint32_t v){
+	data = mem_upsize(data, 5);
+	while( v >= 0x80 ){
+		data[(*mem_len(data))++] = v | 0x80;
+		v >>= 7;
+	}
+	data[(*mem_len(data))++] = v;
+	return data;
+}
+
+//NULL if varint is not terminated before end
+__private const uint8_t* varint_get(const uint8_t* p, const uint8_t* end, uint32_t* v){
+	uint32_t r = 0;
+	unsigned s = 0;
+	while( p < end && *p & 0x80 ){
+		if( s > 21 ) return NULL;
+		r |= (uint32_t)(*p++ & 0x7F) << s;
+		s += 7;
+	}
+	if( p >= end ) return NULL;
+	*v = r | (uint32_t)*p++ << s;
+	return p;
+}
+
+__private void fileindex_it(fileindexIt_s* it, fileindex_s* fi, unsigned block){
+	it->p    = block < fi->hdr->nblock ? &fi->data[fi->blocks[block]] : fi->data;
+	it->end  = (const uint8_t*)fi->names;
+	it->npkg = fi->hdr->npkg;
+	it->len  = 0;
+}
+
+//-1 if entry is corrupted
+__private int fileindex_next(fileindexIt_s* it){
+	uint32_t prefix;
+	uint32_t suffix;
+	if( !(it->p = varint_get(it->p, it->end, &prefix)) ) return -1;
+	if( !(it->p = varint_get(it->p, it->end, &suffix)) ) return -1;
+	if( prefix > it->len || prefix + (uint64_t)suffix >= FILEINDEX_PATH_MAX || suffix > (size_t)(it->end - it->p) ) return -1;
+	memcpy(&it->path[prefix], it->p, suffix);
+	it->p  += suffix;
+	it->len = prefix + suffix;
+	if( !(it->p = varint_get(it->p, it->end, &it->pkg)) || it->pkg >= it->npkg ) return -1;
+	return 0;
+}
+
+__private int path_cmp(const char* a, unsigned alen, const char* b, unsigned blen){
+	const int r = memcmp(a, b, alen < blen ? alen : blen);
+	if( r ) return r;
+	return alen < blen ? -1 : alen > blen;
+}
+
+//return count of owner, path is relative to root without leading /
+unsigned fileindex_owner(fileindex_s* fi, const char* path, unsigned* owner, unsigned max){
+	const unsigned len = strlen(path);
+	const unsigned count = fi->hdr->count;
+	if( !count ) return 0;
+
+	//first block start with path >= of searched, same path can begin in previous block
+	unsigned lo = 0;
+	unsigned hi = fi->hdr->nblock;
+	while( lo < hi ){
+		const unsigned mid = lo + (hi - lo) / 2;
+		fileindexIt_s it;
+		fileindex_it(&it, fi, mid);
+		if( fileindex_next(&it) ){
+			dbg_error("file index corrupted");
+			return 0;
+		}
+		if( path_cmp(it.path, it.len, path, len) < 0 ) lo = mid + 1;
+		else hi = mid;
+	}
+	const unsigned block = lo ? lo - 1 : 0;
+
+	unsigned n = 0;
+	fileindexIt_s it;
+	fileindex_it(&it, fi, block);
+	for( unsigned i = block * FILEINDEX_BLOCK; i < count; ++i ){
+		if( fileindex_next(&it) ){
+			dbg_error("file index corrupted");
+			return 0;
+		}
+		const int cmp = path_cmp(it.path, it.len, path, len);
+		if( cmp > 0 ) break;
+		if( !cmp && n < max ) owner[n++] = it.pkg;
+	}
+	return n;
+}
+
+__private int dir_cmp(const void* a, const void* b){
+	return strcmp(((const fileindexDir_s*)a)->name, ((const fileindexDir_s*)b)->name);
+}
+
+__private int entry_cmp(const void* a, const void* b){
+	const fileindexEntry_s* ea = a;
+	const fileindexEntry_s* eb = b;
+	const int r = path_cmp(ea->path, ea->len, eb->path, eb->len);
+	if( r ) return r;
+	return ea->pkg < eb->pkg ? -1 : ea->pkg > eb->pkg;
+}
+
+__private int fileindex_same(fileindex_s* fi, fileindexDir_s* dirs){
+	if( fi->hdr->npkg != *mem_len(dirs) ) return 0;
+	mforeach(dirs, i){
+		if( fi->pkgs[i].mtime != dirs[i].mtime || strcmp(fileindex_pkg_name(fi, i), dirs[i].name) ) return 0;
+	}
+	return 1;
+}
+
+__private unsigned fileindex_pkg_find(fileindex_s* fi, const char* name){
+	unsigned lo = 0;
+	unsigned hi = fi->hdr->npkg;
+	while( lo < hi ){
+		const unsigned mid = lo + (hi - lo) / 2;
+		const int cmp = strcmp(name, fileindex_pkg_name(fi, mid));
+		if( !cmp ) return mid;
+		if( cmp < 0 ) hi = mid;
+		else lo = mid + 1;
+	}
+	return UINT32_MAX;
+}
+
+//local files: %FILES% section, one path for line, end on empty line
+__private fileindexEntry_s* files_parse(fileindexEntry_s* e, char* buf, unsigned size, unsigned pkg){
+	char* end = buf + size;
+	char* p = memmem(buf, size, "%FILES%\n", 8);
+	if( !p ) return e;
+	p += 8;
+	while( p < end && *p != '\n' ){
+		char* nl = memchr(p, '\n', end - p);
+		if( !nl ) nl = end;
+		if( nl - p < FILEINDEX_PATH_MAX ){
+			const unsigned id = mem_ipush(&e);
+			e[id].path = p;
+			e[id].len  = nl - p;
+			e[id].pkg  = pkg;
+		}
+		else{
+			dbg_warning("path too long in %u", pkg);
+		}
+		p = nl + 1;
+	}
+	return e;
+}
+
+//each block start where the index say with a full path, all entries can be decoded
+__private int fileindex_check(fileindex_s* fi){
+	fileindexIt_s it;
+	fileindex_it(&it, fi, 0);
+	for( unsigned i = 0; i < fi->hdr->count; ++i ){
+		if( !(i % FILEINDEX_BLOCK) ){
+			if( it.p != &fi->data[fi->blocks[i / FILEINDEX_BLOCK]] ) return -1;
+			it.len = 0;
+		}
+		if( fileindex_next(&it) ) return -1;
+	}
+	return 0;
+}
+
+//reuse paths of unchanged packages, copy in one pool because old index is released, old index is checked
+__private fileindexEntry_s* fileindex_reuse(fileindexEntry_s* e, fileindex_s* old, const uint32_t* remap, char** pool){
+	fileindexIt_s it;
+	size_t total = 0;
+	fileindex_it(&it, old, 0);
+	for( unsigned i = 0; i < old->hdr->count; ++i ){
+		fileindex_next(&it);
+		if( remap[it.pkg] != UINT32_MAX ) total += it.len;
+	}
+	*pool = MANY(char, total ? total : 1);
+	char* w = *pool;
+	fileindex_it(&it, old, 0);
+	for( unsigned i = 0; i < old->hdr->count; ++i ){
+		fileindex_next(&it);
+		if( remap[it.pkg] == UINT32_MAX ) continue;
+		memcpy(w, it.path, it.len);
+		const unsigned id = mem_ipush(&e);
+		e[id].path = w;
+		e[id].len  = it.len;
+		e[id].pkg  = remap[it.pkg];
+		w += it.len;
+	}
+	return e;
+}
+
+//reused entries are already sorted, package id keep the order because dirs are sorted, only new entries need sort
+__private fileindexEntry_s* entry_merge(fileindexEntry_s* a, fileindexEntry_s* b){
+	const unsigned na = *mem_len(a);
+	const unsigned nb = *mem_len(b);
+	qsort(b, nb, sizeof(fileindexEntry_s), entry_cmp);
+	fileindexEntry_s* m = MANY(fileindexEntry_s, na + nb + 1);
+	unsigned i = 0;
+	unsigned j = 0;
+	unsigned k = 0;
+	while( i < na && j < nb ) m[k++] = entry_cmp(&a[i], &b[j]) <= 0 ? a[i++] : b[j++];
+	while( i < na ) m[k++] = a[i++];
+	while( j < nb ) m[k++] = b[j++];
+	*mem_len(m) = k;
+	return m;
+}
+
+//entries need to be sorted
+__private fileindex_s* fileindex_build(fileindexDir_s* dirs, fileindexEntry_s* e){
+	const unsigned npkg   = *mem_len(dirs);
+	const unsigned count  = *mem_len(e);
+	const unsigned nblock = (count + FILEINDEX_BLOCK - 1) / FILEINDEX_BLOCK;
+
+	__free char* names = MANY(char, 4096);
+	__free fileindexPkg_s* pkgs = MANY(fileindexPkg_s, npkg ? npkg : 1);
+	mforeach(dirs, i){
+		const unsigned len = strlen(dirs[i].name) + 1;
+		pkgs[i].mtime = dirs[i].mtime;
+		pkgs[i].name  = *mem_len(names);
+		pkgs[i].count = 0;
+		names = mem_upsize(names, len);
+		memcpy(&names[*mem_len(names)], dirs[i].name, len);
+		*mem_len(names) += len;
+	}
+
+	__free uint32_t* blocks = MANY(uint32_t, nblock ? nblock : 1);
+	__free uint8_t* data = MANY(uint8_t, FILEINDEX_DATA_SIZE);
+	for( unsigned i = 0; i < count; ++i ){
+		unsigned prefix = 0;
+		if( i % FILEINDEX_BLOCK ){
+			const unsigned max = e[i].len < e[i-1].len ? e[i].len : e[i-1].len;
+			while( prefix < max && e[i].path[prefix] == e[i-1].path[prefix] ) ++prefix;
+		}
+		else{
+			blocks[i / FILEINDEX_BLOCK] = *mem_len(data);
+		}
+		data = data_varint(data, prefix);
+		data = data_varint(data, e[i].len - prefix);
+		data = mem_upsize(data, e[i].len - prefix);
+		memcpy(&data[*mem_len(data)], &e[i].path[prefix], e[i].len - prefix);
+		*mem_len(data) += e[i].len - prefix;
+		data = data_varint(data, e[i].pkg);
+		++pkgs[e[i].pkg].count;
+	}
+
+	fileindexHeader_s hdr;
+	memset(&hdr, 0, sizeof hdr);
+	memcpy(hdr.magic, FILEINDEX_MAGIC, sizeof FILEINDEX_MAGIC);
+	hdr.version = FILEINDEX_VERSION;
+	hdr.count   = count;
+	hdr.npkg    = npkg;
+	hdr.nblock  = nblock;
+	hdr.pkgs    = sizeof hdr;
+	hdr.blocks  = hdr.pkgs + npkg * sizeof(fileindexPkg_s);
+	hdr.data    = hdr.blocks + nblock * sizeof(uint32_t);
+	hdr.names   = hdr.data + *mem_len(data);
+	hdr.size    = hdr.names + *mem_len(names);
+
+	char* image = MANY(char, hdr.size);
+	memcpy(image, &hdr, sizeof hdr);
+	memcpy(&image[hdr.pkgs], pkgs, npkg * sizeof(fileindexPkg_s));
+	memcpy(&image[hdr.blocks], blocks, nblock * sizeof(uint32_t));
+	memcpy(&image[hdr.data], data, *mem_len(data));
+	memcpy(&image[hdr.names], names, *mem_len(names));
+	*mem_len(image) = hdr.size;
+	return fileindex_image(image, hdr.size, 0);
+}
+
+__private int fileindex_store(fileindex_s* fi, const char* path){
+	__free char* tmppath = str_printf("%s.tmp", path);
+	int fd = open(tmppath, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+	if( fd == -1 ){
+		dbg_warning("unable to create file index %s: %m", tmppath);
+		return -1;
+	}
+	const char* d = fi->map;
+	size_t size = fi->size;
+	while( size ){
+		ssize_t nw = write(fd, d, size);
+		if( nw < 0 ){
+			if( errno == EINTR ) continue;
+			dbg_warning("unable to write file index %s: %m", tmppath);
+			close(fd);
+			unlink(tmppath);
+			return -1;
+		}
+		d    += nw;
+		size -= nw;
+	}
+	close(fd);
+	if( rename(tmppath, path) ){
+		dbg_warning("unable to rename file index %s: %m", tmppath);
+		unlink(tmppath);
+		return -1;
+	}
+	return 0;
+}
+
+//only packages with a new mtime read files, if nothing change the stored index is used
+fileindex_s* fileindex_update(const char* path, const char* localDir, fileindexDir_s* dirs){
+	qsort(dirs, *mem_len(dirs), sizeof(fileindexDir_s), dir_cmp);
+	//open validate header and sections, entries are bounds checked from lookup
+	fileindex_s* old = fileindex_open(path);
+	if( old && fileindex_same(old, dirs) ){
+		dbg_info("file index %s is updated", path);
+		return old;
+	}
+	//reuse copy entries in new index, walk all before trust them
+	if( old && fileindex_check(old) ){
+		dbg_warning("file index %s corrupted, full rebuild", path);
+		mem_free(old);
+		old = NULL;
+	}
+
+	const unsigned ndirs = *mem_len(dirs);
+	__free fileindexEntry_s* e = MANY(fileindexEntry_s, FILEINDEX_ENTRY_SIZE);
+	__free fileindexEntry_s* n = MANY(fileindexEntry_s, FILEINDEX_ENTRY_SIZE);
+	__free char* pool = NULL;
+	__free uint8_t* keep = MANY(uint8_t, ndirs ? ndirs : 1);
+	memset(keep, 0, ndirs ? ndirs : 1);
+	unsigned reused = 0;
+	if( old ){
+		__free uint32_t* remap = MANY(uint32_t, old->hdr->npkg ? old->hdr->npkg : 1);
+		memset(remap, 0xFF, old->hdr->npkg * sizeof(uint32_t));
+		mforeach(dirs, i){
+			const unsigned id = fileindex_pkg_find(old, dirs[i].name);
+			if( id != UINT32_MAX && old->pkgs[id].mtime == dirs[i].mtime ){
+				remap[id] = i;
+				keep[i]   = 1;
+				++reused;
+			}
+		}
+		e = fileindex_reuse(e, old, remap, &pool);
+	}
+
+	char** bufs = MANY(char*, ndirs ? ndirs : 1);
+	mforeach(dirs, i){
+		if( keep[i] ) continue;
+		__free char* filespath = str_printf("%s/%s/files", localDir, dirs[i].name);
+		char* buf = load_file(filespath, 0);
+		if( !buf ) continue;
+		bufs[(*mem_len(bufs))++] = buf;
+		n = files_parse(n, buf, *mem_len(buf), i);
+	}
+	dbg_info("file index reuse %u packages of %u", reused, *mem_len(dirs));
+
+	__free fileindexEntry_s* m = entry_merge(e, n);
+	fileindex_s* fi = fileindex_build(dirs, m);
+	mforeach(bufs, i){
+		mem_free(bufs[i]);
+	}
+	mem_free(bufs);
+	if( old ) mem_free(old);
+	if( fi ) fileindex_store(fi, path);
+	return fi;
+}
+
+//absolute path to index path, parent directory is resolved because file can be a link
+char* fileindex_path(const char* root, const char* path){
+	__free char* full = path_explode(path);
+	if( full[0] != '/' ){
+		char cwd[PATH_MAX];
+		char* tmp = str_printf("%s/%s", getcwd(cwd, PATH_MAX), full);
+		mem_free(full);
+		full = tmp;
+	}
+
+	char* slash = strrchr(full, '/');
+	char real[PATH_MAX];
+	char* abs = NULL;
+	if( slash != full ){
+		*slash = 0;
+		if( realpath(full, real) ) abs = str_printf("%s/%s", strcmp(real, "/") ? real : "", slash + 1);
+		*slash = '/';
+	}
+	if( !abs ) abs = str_dup(full, 0);
+
+	unsigned rlen = strlen(root);
+	while( rlen && root[rlen-1] == '/' ) --rlen;
+	const char* rel = abs;
+	if( rlen && !strncmp(abs, root, rlen) && abs[rlen] == '/' ) rel += rlen;
+	while( *rel == '/' ) ++rel;
+	char* ret = str_dup(rel, 0);
+	mem_free(abs);
+	return ret;
+}
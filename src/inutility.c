@@ -20,6 +20,7 @@
 #include <tree_sitter/tree-sitter-bash.h>
 
 #include <auror/inutility.h>
+#include <auror/evr.h>
 
 char* load_file(const char* fname, int exists){
 	dbg_info("loading %s", fname);
@@ -71,48 +72,9 @@ int dir_exists(const char* path){
 	return 1;
 }
 
+//same result of pacman vercmp, epoch and release are compared alone
 int vercmp(const char *a, const char *b){
-	const char *pa = a, *pb = b;
-	int r = 0;
-	
-	while (*pa || *pb) {
-		if (isdigit(*pa) || isdigit(*pb)) {
-			long la = 0, lb = 0;
-			while (*pa == '0') pa++;
-			while (*pb == '0') pb++;
-			while (isdigit(*pa)) {
-				la = la * 10 + (*pa - '0');
-				pa++;
-			}
-			while (isdigit(*pb)) {
-				lb = lb * 10 + (*pb - '0');
-				pb++;
-			}
-			if (la < lb) {
-				return -1;
-			}
-			else if (la > lb) {
-				return 1;
-			}
-		}
-		else if (*pa && *pb && isalpha(*pa) && isalpha(*pb)) {
-			r = tolower((unsigned char)*pa) - tolower((unsigned char)*pb);
-			if (r != 0) return r;
-			pa++;
-			pb++;
-		}
-		else{
-			char ca = *pa ? *pa : 0;
-			char cb = *pb ? *pb : 0;
-			
-			if (ca == '-' || ca == '_') ca = '.';
-			if (cb == '-' || cb == '_') cb = '.';
-			if (ca != cb) return ca - cb;
-			if (ca) pa++;
-			if (cb) pb++;
-		}
-	}
-	return 0;
+	return evr_vercmp(a, b);
 }
 
 char* path_cats(char* dst, char* src, unsigned len){
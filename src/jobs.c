@@ -11,12 +11,19 @@ __private thr_s**    JOBS;
 __private rbuffer_s  TODO;
 __private unsigned   JCOUNT;
 __private zem_t      AWAIT;
+__private __atomic unsigned QUEUED;
 
 typedef struct work{
-	job_f fn;
-	void* arg;
+	job_f  fn;
+	void*  arg;
+	zem_t* zem;
 }work_s;
 
+__private void job_run(work_s* work){
+	work->fn(work->arg);
+	if( work->zem ) zem_pull(work->zem);
+}
+
 __private void job_work(__unused thr_s* self, __unused void* arg){
 	dbg_info("start");
 	deadpoll_begin(4096);
@@ -24,9 +31,9 @@ __private void job_work(__unused thr_s* self, __unused void* arg){
 		work_s current;
 		dbg_info("wait new job");
 		rbuffer_pop(&TODO, &current, 1);
+		FSUB_A(&QUEUED, 1);
 		dbg_info("start new job");
-		current.fn(current.arg);
-		zem_pull(&AWAIT);
+		job_run(&current);
 	}
 	deadpoll_end();
 }
@@ -36,6 +43,7 @@ void job_begin(unsigned count){
 	JCOUNT = count;
 	JOBS = MANY(thr_s*, JCOUNT);
 	rbuffer_ctor(&TODO, count*2, sizeof(work_s));
+	STORE_L(&QUEUED, 0);
 	for( unsigned i = 0; i < JCOUNT; ++i ){
 		JOBS[i] = thr_new(job_work, NULL, 0, (i%ncpu)+1, 0);
 	}
@@ -44,7 +52,8 @@ void job_begin(unsigned count){
 
 void job_new(job_f j, void* arg, int waitable){
 	if( waitable ) zem_push(&AWAIT, 1);
-	work_s work = {j, arg};
+	work_s work = {j, arg, waitable ? &AWAIT : NULL};
+	FADD_A(&QUEUED, 1);
 	rbuffer_push(&TODO, &work, 1);
 }
 
@@ -52,6 +61,76 @@ void job_wait(void){
 	zem_wait(&AWAIT);
 }
 
+unsigned job_count(void){
+	return JCOUNT;
+}
+
+struct jobGroup{
+	work_s*           work;
+	__atomic unsigned next;
+	__atomic unsigned ref;
+	zem_t             done;
+};
+
+//reserve one slot in queue, a push after a reservation never sleep
+__private int job_reserve(void){
+	unsigned q = LOAD_A(&QUEUED);
+	while( q + 1 < JCOUNT * 2 ){
+		if( CAS_PWA(&QUEUED, &q, q + 1) ) return 1;
+	}
+	return 0;
+}
+
+__private void job_group_release(jobGroup_s* group){
+	if( FSUB_A(&group->ref, 1) == 1 ){
+		mem_free(group->work);
+		mem_free(group);
+	}
+}
+
+//every thread claim the next work of group until all work is claimed
+__private void job_group_claim(jobGroup_s* group){
+	const unsigned count = *mem_len(group->work);
+	unsigned i;
+	while( (i=FADD_A(&group->next, 1)) < count ){
+		job_run(&group->work[i]);
+	}
+}
+
+__private void job_group_help(void* arg){
+	jobGroup_s* group = arg;
+	job_group_claim(group);
+	job_group_release(group);
+}
+
+jobGroup_s* job_group_new(unsigned count){
+	jobGroup_s* group = NEW(jobGroup_s);
+	group->work = MANY(work_s, count ? count : 1);
+	STORE_L(&group->next, 0);
+	STORE_L(&group->ref, 1);
+	zem_ctor(&group->done);
+	return group;
+}
+
+void job_group_add(jobGroup_s* group, job_f j, void* arg){
+	zem_push(&group->done, 1);
+	unsigned id = mem_ipush(&group->work);
+	group->work[id] = (work_s){j, arg, &group->done};
+}
+
+//can be called from a job, idle workers are invited to help but caller run only the work of group, group is released
+void job_group_wait(jobGroup_s* group){
+	const unsigned count = *mem_len(group->work);
+	for( unsigned i = 1; i < count && i < JCOUNT && job_reserve(); ++i ){
+		FADD_A(&group->ref, 1);
+		work_s help = {job_group_help, group, NULL};
+		rbuffer_push(&TODO, &help, 1);
+	}
+	job_group_claim(group);
+	zem_wait(&group->done);
+	job_group_release(group);
+}
+
 void job_end(void){
 	job_wait();
 	for( unsigned i = 0; i < JCOUNT; ++i ){
@@ -57,6 +57,21 @@ char* ctab(unsigned tmp){
 
 #define MAX_CLAUSE 128
 
+__private void dependency_clauses(solver_s* s, arch_s* arch, desc_s* desc, unsigned tab);
+
+__private unsigned candidate_clause(solver_s* s, arch_s* arch, desc_s* candy, c_Lit* clause, unsigned nc, unsigned tab){
+	const unsigned varcandy = sat_var(s, candy);
+	if( nc >= MAX_CLAUSE ) die("internal error, required more than %u clause, please report this issue", MAX_CLAUSE);
+	clause[nc++] = sat_lit(varcandy, 0);
+	dbg_info("%s++%s", ctab(tab), candy->name);
+	if( !(candy->flags & DESC_FLAG_CROSS) ){
+		candy->flags |= DESC_FLAG_CROSS;
+		dependency_clauses(s, arch, candy, tab+1);
+	}
+	return nc;
+}
+
+//candidates are from first repository that have the name, real package checked one by one, provides are already filtered by version
 __private void dependency_clauses(solver_s* s, arch_s* arch, desc_s* desc, unsigned tab) {
 	if( !desc->depends ) return;
 	if( desc->conflicts ){
@@ -64,32 +79,33 @@ __private void dependency_clauses(solver_s* s, arch_s* arch, desc_s* desc, unsig
 	}
 	dbg_info("%sdependency of %s", ctab(tab),desc->name);
 	const unsigned var = sat_var(s, desc);
+	__free desc_s** provides = MANY(desc_s*, 16);
 	mforeach(desc->depends, i){
 		dbg_info("%sdepends %s", ctab(tab),desc->depends[i].name);
-		desc_s* candidates = database_sync_find(arch->sync, desc->depends[i].name);
-		if( !candidates ) die("unable to solve dependency %s required by %s", desc->depends[i].name, desc->name);
+		unsigned nrepo;
+		database_s** repo = database_sync_repository(arch, desc->depends[i].atom, &nrepo);
+		if( !nrepo ) die("unable to solve dependency %s required by %s", desc->depends[i].name, desc->name);
 		c_Lit clause[MAX_CLAUSE];
 		unsigned nc = 0;
 		clause[nc++] = sat_lit(var, 1);
-		int foundCandidate = 0;
-		ldforeach(candidates, candy){
+		unsigned ncandy;
+		desc_s** candidates = database_candidates(repo[0], desc->depends[i].atom, &ncandy);
+		for( unsigned k = 0; k < ncandy; ++k ){
+			desc_s* candy = candidates[k];
 			dbg_info("%scheck candydate: %s 0x%X %s", ctab(tab), candy->name, desc->depends[i].flags, desc->depends[i].version);
-			if( desc_accept_version(candy, desc->depends[i].flags, desc->depends[i].version) ){
-				const unsigned varcandy = sat_var(s, candy);
-				if( nc >= MAX_CLAUSE ) die("internal error, required more than %u clause, please report this issue", MAX_CLAUSE);
-				clause[nc++] = sat_lit(varcandy, 0);
-				foundCandidate = 1;
-				dbg_info("%s++%s", ctab(tab), candy->name);
-				if( !(candy->flags & DESC_FLAG_CROSS) ){
-					candy->flags |= DESC_FLAG_CROSS;
-					dependency_clauses(s, arch, candy, tab+1);
-				}
+			if( desc_accept_version(candy, desc->depends[i].flags, &desc->depends[i].evr) ){
+				nc = candidate_clause(s, arch, candy, clause, nc, tab);
 			}
 			else{
 				dbg_info("%s##%s.%s unmatch %s.%s", ctab(tab), candy->name, candy->version, desc->depends[i].name, desc->depends[i].version);
 			}
 		}
-		if( !foundCandidate ) die("unable to find candidate to solve dependency %s required by %s", desc->depends[i].name, desc->name);
+		*mem_len(provides) = 0;
+		provides = database_provides_accept(repo[0], provides, desc->depends[i].atom, desc->depends[i].flags, &desc->depends[i].evr);
+		mforeach(provides, p){
+			nc = candidate_clause(s, arch, provides[p], clause, nc, tab);
+		}
+		if( nc < 2 ) die("unable to find candidate to solve dependency %s required by %s", desc->depends[i].name, desc->name);
 		cmsat_add_clause(s->sat, clause, nc);
 	}
 }
@@ -100,10 +116,10 @@ desc_s** package_resolve(arch_s* arch){
 	solver_s s;
 	sat_ctor(&s);
 
-	rbtreeit_s it;
-	rbtreeit_ctor(&it, &arch->local->elements, 0);
-	desc_s* desc;
-	while( (desc=rbtree_iterate_inorder(&it)) ){
+	__free desc_s** tmp = arch->local->flags & DATABASE_FLAG_FROZEN ? NULL : database_sorted(arch->local);
+	desc_s** local = tmp ? tmp : arch->local->elements;
+	mforeach(local, i){
+		desc_s* desc = local[i];
 		if( desc->reason ){
 			dbg_info("~~%s is dependency, skip", desc->name);
 			continue;
@@ -116,9 +132,9 @@ desc_s** package_resolve(arch_s* arch){
 			dbg_info("^^%s is makepkg, skip", desc->name);
 			continue;
 		}
-		desc_s* candy = desc_nonvirtual(database_sync_find(arch->sync, desc->name));
+		desc_s* candy = desc_nonvirtual(database_sync_find_atom(arch, desc->atom));
 		if( !candy ){
-			desc_nonvirtual_dump(database_sync_find(arch->sync, desc->name));
+			desc_nonvirtual_dump(database_sync_find_atom(arch, desc->atom));
 			die("internal error, unable to find package %s", desc->name);
 		}
 		if( candy->flags & DESC_FLAG_CROSS ) {
@@ -169,7 +185,6 @@ desc_s** package_resolve(arch_s* arch){
 	}
 	
 	
-	rbtreeit_dtor(&it);
 	sat_dtor(&s);
 	dbg_info("end");
 	return ret;
@@ -178,7 +193,7 @@ desc_s** package_resolve(arch_s* arch){
 /*desc_s** package_cross_dependency(arch_s* arch, desc_s* desc, desc_s** out, unsigned tmp){
 	if( !desc->depends ) return out;
 	mforeach(desc->depends, i){
-		desc_s* dep = database_sync_find(arch->sync, desc->depends[i].name);
+		desc_s* dep = database_sync_find(arch, desc->depends[i].name);
 		if( !dep ) die("internal error, unable to resolve dependency '%s'", desc->depends[i].name);
 		ldforeach(dep, it){
 			desc_s* d = it->flags & (DESC_FLAG_PROVIDE | DESC_FLAG_REMOVED) ? it->link : it;
@@ -213,7 +228,7 @@ desc_s** package_cross_installed(arch_s* arch){
 			dbg_info("^^%s is makepkg, skip", desc->name);
 			continue;
 		}
-		desc_s* dsync = database_sync_find(arch->sync, desc->name);
+		desc_s* dsync = database_sync_find(arch, desc->name);
 		if( !dsync ) die("internal error, unable to find package %s", desc->name);
 		ldforeach(dsync, it){
 			desc_s* lk;
@@ -0,0 +1,291 @@
+#include <notstd/core.h>
+#include <notstd/str.h>
+
+#include <auror/snapshot.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#define SNAPSHOT_WORDS_SIZE   (4096*16)
+#define SNAPSHOT_STRINGS_SIZE (4096*64)
+
+int snapshot_key(snapshotKey_s* key, const char* dbpath){
+	int fd = open(dbpath, O_RDONLY);
+	if( fd == -1 ){
+		dbg_warning("unable to open %s: %m", dbpath);
+		return -1;
+	}
+	struct stat st;
+	if( fstat(fd, &st) || (size_t)st.st_size < sizeof key->tail ){
+		dbg_warning("unable to stat %s", dbpath);
+		close(fd);
+		return -1;
+	}
+	key->size  = st.st_size;
+	key->tail  = 0;
+	if( pread(fd, &key->tail, sizeof key->tail, st.st_size - sizeof key->tail) != sizeof key->tail ){
+		dbg_warning("unable to read tail of %s: %m", dbpath);
+		close(fd);
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
+__private void snapshot_cleanup(void* psnap){
+	snapshot_s* snap = psnap;
+	if( snap->sorted ) mem_free(snap->sorted);
+	if( snap->map ) munmap(snap->map, snap->size);
+}
+
+//sections are in order of write, each entry point to a path and a record inside the map
+__private int snapshot_layout(snapshot_s* snap){
+	const snapshotHeader_s* hdr = snap->hdr;
+	if( hdr->fields != sizeof(snapshotHeader_s) ) return -1;
+	if( hdr->entries < hdr->fields || hdr->records < hdr->entries || hdr->strings < hdr->records || hdr->size < hdr->strings ) return -1;
+	if( (hdr->entries - hdr->fields) % sizeof(uint32_t) || (hdr->strings - hdr->records) % sizeof(uint32_t) ) return -1;
+	if( hdr->records - hdr->entries != (uint64_t)hdr->count * sizeof(snapshotEntry_s) ) return -1;
+	if( (hdr->strings - hdr->records) / sizeof(uint32_t) > UINT32_MAX || hdr->size - hdr->strings > UINT32_MAX ) return -1;
+	const char* map = snap->map;
+	//field table and strings end with 0, any string inside is terminated
+	if( hdr->entries == hdr->fields || map[hdr->entries - 1] ) return -1;
+	if( hdr->size > hdr->strings && map[hdr->size - 1] ) return -1;
+	snap->fields  = (const char*)((uintptr_t)map + hdr->fields);
+	snap->entries = (snapshotEntry_s*)((uintptr_t)map + hdr->entries);
+	snap->records = (const uint32_t*)((uintptr_t)map + hdr->records);
+	snap->strings = (char*)((uintptr_t)map + hdr->strings);
+	snap->words   = (hdr->strings - hdr->records) / sizeof(uint32_t);
+	snap->strsize = hdr->size - hdr->strings;
+	for( unsigned i = 0; i < hdr->count; ++i ){
+		if( snap->entries[i].path >= snap->strsize || snap->entries[i].record >= snap->words ) return -1;
+	}
+	return 0;
+}
+
+snapshot_s* snapshot_map(const char* path){
+	int fd = open(path, O_RDONLY);
+	if( fd == -1 ){
+		dbg_info("snapshot %s not exists", path);
+		return NULL;
+	}
+	struct stat st;
+	if( fstat(fd, &st) || (size_t)st.st_size < sizeof(snapshotHeader_s) ){
+		dbg_warning("invalid snapshot %s", path);
+		close(fd);
+		return NULL;
+	}
+	void* map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if( map == MAP_FAILED ){
+		dbg_error("unable to map %s: %m", path);
+		return NULL;
+	}
+
+	snapshot_s* snap = NEW(snapshot_s, snapshot_cleanup);
+	snap->map    = map;
+	snap->size   = st.st_size;
+	snap->hdr    = map;
+	snap->sorted = NULL;
+	if( memcmp(snap->hdr->magic, SNAPSHOT_MAGIC, sizeof SNAPSHOT_MAGIC) || snap->hdr->version != SNAPSHOT_VERSION || snap->hdr->size != snap->size ){
+		dbg_warning("snapshot %s wrong magic, version or size", path);
+		mem_free(snap);
+		return NULL;
+	}
+	if( snapshot_layout(snap) ){
+		dbg_warning("snapshot %s corrupted", path);
+		mem_free(snap);
+		return NULL;
+	}
+	return snap;
+}
+
+int snapshot_check_key(snapshot_s* snap, const char* dbpath){
+	snapshotKey_s key;
+	if( snapshot_key(&key, dbpath) ) return -1;
+	if( memcmp(&snap->hdr->key, &key, sizeof key) ){
+		dbg_info("snapshot of %s is old", dbpath);
+		return -1;
+	}
+	return 0;
+}
+
+const char* snapshot_field_name(snapshot_s* snap, unsigned id){
+	const char* name = snap->fields;
+	const char* end  = (const char*)snap->entries;
+	while( id-->0 && name < end ) name += strlen(name) + 1;
+	return name < end && *name ? name : NULL;
+}
+
+__private int entry_cmp(const void* a, const void* b, void* psnap){
+	snapshot_s* snap = psnap;
+	return strcmp(&snap->strings[snap->entries[*(const uint32_t*)a].path], &snap->strings[snap->entries[*(const uint32_t*)b].path]);
+}
+
+//need to be called before search, find is read only and can be used from more threads
+void snapshot_entry_index(snapshot_s* snap){
+	const unsigned count = snap->hdr->count;
+	snap->sorted = MANY(uint32_t, count ? count : 1);
+	for( unsigned i = 0; i < count; ++i ){
+		snap->sorted[i] = i;
+	}
+	*mem_len(snap->sorted) = count;
+	qsort_r(snap->sorted, count, sizeof(uint32_t), entry_cmp, snap);
+}
+
+const uint32_t* snapshot_entry_find(snapshot_s* snap, const char* path, uint32_t crc, uint32_t size){
+	unsigned lo = 0;
+	unsigned hi = *mem_len(snap->sorted);
+	while( lo < hi ){
+		const unsigned mid = lo + (hi - lo) / 2;
+		const snapshotEntry_s* e = &snap->entries[snap->sorted[mid]];
+		const int cmp = strcmp(path, &snap->strings[e->path]);
+		if( !cmp ){
+			if( e->crc != crc || e->size != size ) return NULL;
+			return &snap->records[e->record];
+		}
+		if( cmp < 0 ) hi = mid;
+		else lo = mid + 1;
+	}
+	return NULL;
+}
+
+uint64_t snapshot_u64(const uint32_t* w){
+	uint64_t v;
+	memcpy(&v, w, sizeof v);
+	return v;
+}
+
+char* snapshot_str(snapshot_s* snap, uint32_t off){
+	return off == SNAPSHOT_NONE ? NULL : &snap->strings[off];
+}
+
+int snapshot_str_valid(snapshot_s* snap, uint32_t off){
+	return off == SNAPSHOT_NONE || off < snap->strsize;
+}
+
+snapw_s* snapw_ctor(snapw_s* sw){
+	sw->words   = MANY(uint32_t, SNAPSHOT_WORDS_SIZE);
+	sw->strings = MANY(char, SNAPSHOT_STRINGS_SIZE);
+	sw->fields  = MANY(char, 512);
+	sw->entries = MANY(snapshotEntry_s, 1024);
+	sw->count   = 0;
+	return sw;
+}
+
+void snapw_dtor(void* psw){
+	snapw_s* sw = psw;
+	mem_free(sw->words);
+	mem_free(sw->strings);
+	mem_free(sw->fields);
+	mem_free(sw->entries);
+}
+
+void snapw_field(snapw_s* sw, const char* name){
+	const unsigned len = strlen(name) + 1;
+	sw->fields = mem_upsize(sw->fields, len);
+	memcpy(&sw->fields[*mem_len(sw->fields)], name, len);
+	*mem_len(sw->fields) += len;
+}
+
+void snapw_word(snapw_s* sw, uint32_t w){
+	sw->words = mem_push(sw->words, &w);
+}
+
+void snapw_u64(snapw_s* sw, uint64_t v){
+	uint32_t w[2];
+	memcpy(w, &v, sizeof v);
+	snapw_word(sw, w[0]);
+	snapw_word(sw, w[1]);
+}
+
+__private uint32_t snapw_blob(snapw_s* sw, const char* str, unsigned len){
+	const unsigned off = *mem_len(sw->strings);
+	sw->strings = mem_upsize(sw->strings, len + 1);
+	memcpy(&sw->strings[off], str, len);
+	sw->strings[off + len] = 0;
+	*mem_len(sw->strings) += len + 1;
+	return off;
+}
+
+void snapw_str(snapw_s* sw, const char* str){
+	snapw_word(sw, str ? snapw_blob(sw, str, strlen(str)) : SNAPSHOT_NONE);
+}
+
+void snapw_strn(snapw_s* sw, const char* str, unsigned len){
+	snapw_word(sw, snapw_blob(sw, str, len));
+}
+
+//called before store the desc, record start from next word
+void snapw_entry(snapw_s* sw, const char* path, uint32_t crc, uint32_t size){
+	const unsigned id = mem_ipush(&sw->entries);
+	sw->entries[id].path   = snapw_blob(sw, path, strlen(path));
+	sw->entries[id].crc    = crc;
+	sw->entries[id].size   = size;
+	sw->entries[id].record = *mem_len(sw->words);
+}
+
+__private int write_all(int fd, const void* data, size_t size){
+	const char* d = data;
+	while( size ){
+		ssize_t nw = write(fd, d, size);
+		if( nw < 0 ){
+			if( errno == EINTR ) continue;
+			return -1;
+		}
+		d    += nw;
+		size -= nw;
+	}
+	return 0;
+}
+
+int snapw_store(snapw_s* sw, const char* path, const char* dbpath){
+	snapshotHeader_s hdr;
+	memset(&hdr, 0, sizeof hdr);
+	if( snapshot_key(&hdr.key, dbpath) ) return -1;
+	memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof SNAPSHOT_MAGIC);
+	hdr.version = SNAPSHOT_VERSION;
+	hdr.count   = sw->count;
+
+	//the field table is terminated with an empty name, records and strings are aligned for map words
+	sw->fields = mem_upsize(sw->fields, sizeof(uint32_t));
+	do{
+		sw->fields[(*mem_len(sw->fields))++] = 0;
+	}while( *mem_len(sw->fields) % sizeof(uint32_t) );
+	if( *mem_len(sw->entries) != sw->count ){
+		dbg_error("snapshot entries %u not match records %u", *mem_len(sw->entries), sw->count);
+		return -1;
+	}
+	hdr.fields  = sizeof hdr;
+	hdr.entries = hdr.fields + *mem_len(sw->fields);
+	hdr.records = hdr.entries + *mem_len(sw->entries) * sizeof(snapshotEntry_s);
+	hdr.strings = hdr.records + *mem_len(sw->words) * sizeof(uint32_t);
+	hdr.size    = hdr.strings + *mem_len(sw->strings);
+
+	__free char* tmppath = str_printf("%s.tmp", path);
+	int fd = open(tmppath, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+	if( fd == -1 ){
+		dbg_warning("unable to create snapshot %s: %m", tmppath);
+		return -1;
+	}
+	if( write_all(fd, &hdr, sizeof hdr)
+		|| write_all(fd, sw->fields, *mem_len(sw->fields))
+		|| write_all(fd, sw->entries, *mem_len(sw->entries) * sizeof(snapshotEntry_s))
+		|| write_all(fd, sw->words, *mem_len(sw->words) * sizeof(uint32_t))
+		|| write_all(fd, sw->strings, *mem_len(sw->strings))
+	){
+		dbg_warning("unable to write snapshot %s: %m", tmppath);
+		close(fd);
+		unlink(tmppath);
+		return -1;
+	}
+	close(fd);
+	if( rename(tmppath, path) ){
+		dbg_warning("unable to rename snapshot %s: %m", tmppath);
+		unlink(tmppath);
+		return -1;
+	}
+	dbg_info("snapshot %s stored, %u desc", path, sw->count);
+	return 0;
+}
@@ -67,6 +67,7 @@ __private const char* www_errno_http(long resCode) {
 		case 204: return "HTTP No Content";
 		case 301: return "HTTP Moved Permanently";
 		case 302: return "HTTP Found";
+		case 304: return "HTTP Not Modified";
 		case 400: return "HTTP Bad Request";
 		case 401: return "HTTP Unauthorized";
 		case 403: return "HTTP Forbidden";
@@ -115,6 +116,7 @@ char* url_escape(const char* url){
 void www_dtor(void* pw){
 	www_s* w = pw;
 	curl_easy_cleanup(w->curl);
+	if( w->header ) curl_slist_free_all(w->header);
 	mem_free(w->resturl);
 }
 
@@ -131,6 +133,8 @@ __private void set_url(www_s* w, const char* url){
 www_s* www_ctor(www_s* w, const char* url, unsigned retry, delay_t relaxms){
 	w->progctx = NULL;
 	w->resturl = NULL;
+	w->header  = NULL;
+	w->restart = NULL;
 	w->error   = 0;
 	w->relax   = relaxms < 1 ? relaxms: 100;
 	w->retry   = retry < 1 ? 1: retry;
@@ -149,6 +153,8 @@ int www_perform(www_s* w){
 	unsigned retry = w->retry;
 	int ret = 0;
 	while( retry-->0 ){
+		if( ret && w->restart && w->restart(w->restartctx) ) break;
+		ret = 0;
 		res = curl_easy_perform(w->curl);
 		if( res != CURLE_OK && res != CURLE_FTP_COULDNT_RETR_FILE ){
 			w->error = res;
@@ -159,6 +165,11 @@ int www_perform(www_s* w){
 		}
 		long resCode;
 		curl_easy_getinfo(w->curl, CURLINFO_RESPONSE_CODE, &resCode);
+		if( resCode == 304L ){
+			dbg_info("not modified");
+			w->error = WWW_ERROR_HTTP + resCode;
+			return WWW_NOT_MODIFIED;
+		}
 		if( resCode != 200L && resCode != 0 ) {
 			dbg_info("http error");
 			w->error = WWW_ERROR_HTTP + resCode;
@@ -213,6 +224,23 @@ void www_download_custom(www_s* w, wwwDownload_f fn, void* ctx){
 	curl_easy_setopt(w->curl, CURLOPT_WRITEDATA, ctx);
 }
 
+void www_header_add(www_s* w, const char* header){
+	struct curl_slist* h = curl_slist_append(w->header, header);
+	if( !h ) die("unable to add header");
+	w->header = h;
+	curl_easy_setopt(w->curl, CURLOPT_HTTPHEADER, w->header);
+}
+
+void www_header_custom(www_s* w, wwwDownload_f fn, void* ctx){
+	curl_easy_setopt(w->curl, CURLOPT_HEADERFUNCTION, fn);
+	curl_easy_setopt(w->curl, CURLOPT_HEADERDATA, ctx);
+}
+
+void www_restart_custom(www_s* w, wwwRestart_f fn, void* ctx){
+	w->restart    = fn;
+	w->restartctx = ctx;
+}
+
 __private size_t progress_callback(void *userctx, curl_off_t dltotal, curl_off_t dlnow, __unused curl_off_t ultotal, __unused curl_off_t ulnow){
 	www_s* w = userctx;
 	curl_off_t bs = 0;
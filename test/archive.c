@@ -0,0 +1,85 @@
+#include <notstd/core.h>
+#include <notstd/str.h>
+
+#include <auror/archive.h>
+
+#include <stdio.h>
+#include <zstd.h>
+
+#define TEST_SIZE (1024*1024)
+
+__private unsigned FAIL;
+
+#define test_check(COND, FMT, ARGS...) do{\
+	if( !(COND) ){\
+		fprintf(stderr, "fail %s:%u " FMT "\n", __FILE__, __LINE__, ## ARGS);\
+		++FAIL;\
+	}\
+}while(0)
+
+//very compressible text, output is many times the input and one small buffer is always full
+__private char* test_plain(size_t size){
+	char* plain = MANY(char, size);
+	for( size_t i = 0; i < size; ++i ){
+		plain[i] = 'a' + (i / 64) % 26;
+	}
+	mem_header(plain)->len = size;
+	return plain;
+}
+
+__private char* test_zstd(const char* plain, size_t size){
+	const size_t bound = ZSTD_compressBound(size);
+	char* frame = MANY(char, bound);
+	const size_t ret = ZSTD_compress(frame, bound, plain, size, 19);
+	if( ZSTD_isError(ret) ) die("zstd compress: %s", ZSTD_getErrorName(ret));
+	mem_header(frame)->len = ret;
+	return frame;
+}
+
+__private void test_zstd_chunked(void){
+	__free char* plain = test_plain(TEST_SIZE);
+	__free char* frame = test_zstd(plain, TEST_SIZE);
+	const size_t chunks[] = { 1, 7, 512, ZSTD_DStreamOutSize() };
+	for( unsigned i = 0; i < sizeof chunks / sizeof chunks[0]; ++i ){
+		__free char* dec = zstd_decompress_chunked(frame, chunks[i]);
+		test_check(dec, "chunk %zu return NULL", chunks[i]);
+		if( !dec ) continue;
+		test_check(mem_header(dec)->len == TEST_SIZE, "chunk %zu size %zu", chunks[i], (size_t)mem_header(dec)->len);
+		test_check(mem_header(dec)->len == TEST_SIZE && !memcmp(dec, plain, TEST_SIZE), "chunk %zu data mismatch", chunks[i]);
+	}
+}
+
+__private void test_zstd_multiframe(void){
+	__free char* plain = test_plain(TEST_SIZE);
+	__free char* frame = test_zstd(plain, TEST_SIZE);
+	const size_t fsize = mem_header(frame)->len;
+	__free char* twice = MANY(char, fsize * 2);
+	memcpy(twice, frame, fsize);
+	memcpy(&twice[fsize], frame, fsize);
+	mem_header(twice)->len = fsize * 2;
+	__free char* dec = zstd_decompress_chunked(twice, 3);
+	test_check(dec && mem_header(dec)->len == TEST_SIZE * 2, "two frames not decompressed");
+	test_check(dec && !memcmp(dec, plain, TEST_SIZE) && !memcmp(&dec[TEST_SIZE], plain, TEST_SIZE), "two frames data mismatch");
+}
+
+__private void test_zstd_truncated(void){
+	__free char* plain = test_plain(TEST_SIZE);
+	__free char* frame = test_zstd(plain, TEST_SIZE);
+	mem_header(frame)->len -= 4;
+	void* dec = zstd_decompress_chunked(frame, 5);
+	test_check(!dec, "truncated frame accepted");
+	mem_free(dec);
+}
+
+int main(void){
+	notstd_begin();
+	test_zstd_chunked();
+	test_zstd_multiframe();
+	test_zstd_truncated();
+	if( FAIL ){
+		fprintf(stderr, "%u test failed\n", FAIL);
+		return 1;
+	}
+	puts("archive ok");
+	return 0;
+}